@@ -0,0 +1,251 @@
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/count_allocations.hpp>
+#include <mapbox/geojson/memory.hpp>
+#include <mapbox/geojson/rapidjson.hpp>
+#include <mapbox/geojson/value.hpp>
+
+#include "datasets.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <map>
+#include <sstream>
+
+using namespace mapbox::geojson;
+
+static linear_ring makeRing(std::size_t size) {
+    linear_ring ring;
+    ring.reserve(size + 1);
+    for (std::size_t i = 0; i < size; ++i) {
+        const double angle = 2 * M_PI * double(i) / double(size);
+        ring.emplace_back(std::cos(angle), std::sin(angle));
+    }
+    ring.push_back(ring.front());
+    return ring;
+}
+
+static void BM_ValueFromPolygon(benchmark::State &state) {
+    const geojson input{ geometry{ polygon{ makeRing(std::size_t(state.range(0))) } } };
+    std::size_t count = 0;
+    std::size_t iterations = 0;
+
+    while (state.KeepRunning()) {
+        allocation_counter counter;
+        value result = convert(input);
+        benchmark::DoNotOptimize(result);
+        count += counter.stats().allocations;
+        ++iterations;
+    }
+
+    state.counters["allocs"] = double(count) / double(iterations);
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ValueFromPolygon)->Arg(1000)->Arg(100000);
+
+static void BM_ValueFromFeatureCollection(benchmark::State &state) {
+    feature_collection collection;
+    collection.reserve(std::size_t(state.range(0)));
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        feature f{ point{ double(i), double(-i) } };
+        f.id = std::uint64_t(i);
+        f.properties.emplace("name", std::string("feature"));
+        f.properties.emplace("rank", std::int64_t(i));
+        collection.push_back(std::move(f));
+    }
+    const geojson input{ std::move(collection) };
+    std::size_t count = 0;
+    std::size_t iterations = 0;
+
+    while (state.KeepRunning()) {
+        allocation_counter counter;
+        value result = convert(input);
+        benchmark::DoNotOptimize(result);
+        count += counter.stats().allocations;
+        ++iterations;
+    }
+
+    state.counters["allocs"] = double(count) / double(iterations);
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ValueFromFeatureCollection)->Arg(10000);
+
+static std::string makeLineStringJSON(std::size_t size) {
+    std::stringstream json;
+    json << R"({"type": "LineString", "coordinates": [)";
+    for (std::size_t i = 0; i < size; ++i) {
+        const double angle = 2 * M_PI * double(i) / double(size);
+        json << (i ? "," : "") << "[" << std::cos(angle) * 100 << "," << std::sin(angle) * 100 << "]";
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Arg 0 parses at full resolution; arg 1 simplifies and snaps while parsing.
+static void BM_ParseLineString(benchmark::State &state) {
+    const std::string json = makeLineStringJSON(100000);
+    parse_options options;
+    if (state.range(0)) {
+        options.tolerance = 1;
+        options.grid      = 0.01;
+    }
+    std::size_t count = 0;
+    std::size_t iterations = 0;
+
+    while (state.KeepRunning()) {
+        allocation_counter counter;
+        geojson result = state.range(0) ? parse(json, options) : parse(json);
+        benchmark::DoNotOptimize(result);
+        count += counter.stats().allocations;
+        ++iterations;
+    }
+
+    state.counters["allocs"] = double(count) / double(iterations);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(json.size()));
+}
+BENCHMARK(BM_ParseLineString)->Arg(0)->Arg(1);
+
+// Arg 1 converts coordinates exactly; arg 0 uses the fast approximate conversion.
+static void BM_ParseCoordinates(benchmark::State &state) {
+    const std::string json = makeLineStringJSON(100000);
+    parse_options options;
+    options.full_precision = state.range(0) != 0;
+
+    while (state.KeepRunning()) {
+        geojson result = parse(json, options);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(json.size()));
+}
+BENCHMARK(BM_ParseCoordinates)->Arg(1)->Arg(0);
+
+// Arg is the number of decimal places; -1 writes the shortest round trip representation.
+static void BM_StringifyPolygon(benchmark::State &state) {
+    linear_ring ring = makeRing(100000);
+    for (auto &p : ring) {
+        p.x = p.x * 180 / M_PI;
+        p.y = p.y * 90 / M_PI;
+    }
+    const geojson input{ geometry{ polygon{ std::move(ring) } } };
+    stringify_options options;
+    options.decimal_places = int(state.range(0));
+    std::size_t bytes = 0;
+
+    while (state.KeepRunning()) {
+        std::string result = stringify(input, options);
+        bytes = result.size();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["output_bytes"] = double(bytes);
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(bytes));
+}
+BENCHMARK(BM_StringifyPolygon)->Arg(-1)->Arg(6);
+
+// Datasets are generated once per process and shared by the benchmarks below.
+static const bench::sample &sample(benchmark::State &state) {
+    static std::map<bench::dataset, bench::sample> samples;
+    const auto kind = bench::dataset(state.range(0));
+    auto it         = samples.find(kind);
+    if (it == samples.end()) {
+        it = samples.emplace(kind, bench::make(kind)).first;
+    }
+    state.SetLabel(bench::name(kind));
+    return it->second;
+}
+
+// Reports MB/s of GeoJSON text and features/s (as items/s) for the whole run.
+static void setThroughput(benchmark::State &state, const bench::sample &input) {
+    state.SetBytesProcessed(std::int64_t(state.iterations()) * std::int64_t(input.json.size()));
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * std::int64_t(input.features.size()));
+}
+
+static void datasets(benchmark::internal::Benchmark *b) {
+    for (auto kind : { bench::dataset::Points, bench::dataset::Polygons, bench::dataset::Properties,
+                       bench::dataset::Collections }) {
+        b->Arg(int(kind));
+    }
+    b->Unit(benchmark::kMillisecond);
+}
+
+static void BM_Parse(benchmark::State &state) {
+    const auto &input = sample(state);
+    while (state.KeepRunning()) {
+        geojson result = parse(input.json);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_Parse)->Apply(datasets);
+
+// Parses through the visitor events rather than a document.
+static void BM_ParseEvents(benchmark::State &state) {
+    const auto &input = sample(state);
+    const parse_options options;
+    while (state.KeepRunning()) {
+        geojson result = parse(input.json, options);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_ParseEvents)->Apply(datasets);
+
+static void BM_ConvertFromRapidJSON(benchmark::State &state) {
+    const auto &input = sample(state);
+    rapidjson_document d;
+    d.Parse(input.json.c_str());
+    while (state.KeepRunning()) {
+        geojson result = convert(d);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_ConvertFromRapidJSON)->Apply(datasets);
+
+static void BM_ConvertToRapidJSON(benchmark::State &state) {
+    const auto &input = sample(state);
+    const geojson features{ input.features };
+    while (state.KeepRunning()) {
+        rapidjson_allocator allocator;
+        rapidjson_value result = convert(features, allocator);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_ConvertToRapidJSON)->Apply(datasets);
+
+static void BM_ConvertFromValue(benchmark::State &state) {
+    const auto &input    = sample(state);
+    const value features = convert(geojson{ input.features });
+    while (state.KeepRunning()) {
+        geojson result = convert(features);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_ConvertFromValue)->Apply(datasets);
+
+static void BM_ConvertToValue(benchmark::State &state) {
+    const auto &input = sample(state);
+    const geojson features{ input.features };
+    while (state.KeepRunning()) {
+        value result = convert(features);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_ConvertToValue)->Apply(datasets);
+
+static void BM_Stringify(benchmark::State &state) {
+    const auto &input = sample(state);
+    const geojson features{ input.features };
+    while (state.KeepRunning()) {
+        std::string result = stringify(features);
+        benchmark::DoNotOptimize(result);
+    }
+    setThroughput(state, input);
+}
+BENCHMARK(BM_Stringify)->Apply(datasets);
+
+BENCHMARK_MAIN();
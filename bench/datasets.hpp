@@ -0,0 +1,167 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace bench {
+
+using namespace mapbox::geojson;
+
+// Synthetic inputs shaped like the data seen in practice. Every generator is deterministic, so
+// runs are comparable between builds.
+enum class dataset {
+    Points,      // many features, each a small point with a few properties
+    Polygons,    // few features, each a polygon with very long rings
+    Properties,  // features with many, partly nested, properties
+    Collections, // features with deeply nested geometry collections
+};
+
+inline const char *name(dataset kind) {
+    switch (kind) {
+    case dataset::Points:
+        return "points";
+    case dataset::Polygons:
+        return "polygons";
+    case dataset::Properties:
+        return "properties";
+    case dataset::Collections:
+        return "collections";
+    }
+    return "";
+}
+
+// A small linear congruential generator; std::rand differs between platforms.
+class generator {
+public:
+    double next(double min, double max) {
+        state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+        return min + double(state_ >> 11) / double(1ULL << 53) * (max - min);
+    }
+
+private:
+    std::uint64_t state_ = 42;
+};
+
+inline linear_ring makeRing(generator &rng, point center, double radius, std::size_t size) {
+    linear_ring ring;
+    ring.reserve(size + 1);
+    for (std::size_t i = 0; i < size; ++i) {
+        const double angle = 2 * M_PI * double(i) / double(size);
+        const double r     = radius * rng.next(0.9, 1.0);
+        ring.emplace_back(center.x + r * std::cos(angle), center.y + r * std::sin(angle));
+    }
+    ring.push_back(ring.front());
+    return ring;
+}
+
+inline feature_collection makePoints(std::size_t count) {
+    generator rng;
+    feature_collection result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        feature f{ point{ rng.next(-180, 180), rng.next(-85, 85) } };
+        f.id = std::uint64_t(i);
+        f.properties.emplace("name", std::string("poi ") + std::to_string(i));
+        f.properties.emplace("rank", std::int64_t(i % 10));
+        result.push_back(std::move(f));
+    }
+    return result;
+}
+
+inline feature_collection makePolygons(std::size_t count, std::size_t size) {
+    generator rng;
+    feature_collection result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const point center{ rng.next(-170, 170), rng.next(-80, 80) };
+        polygon shape{ makeRing(rng, center, 5, size), makeRing(rng, center, 1, size / 10) };
+        std::reverse(shape.back().begin(), shape.back().end());
+        feature f{ std::move(shape) };
+        f.properties.emplace("name", std::string("region ") + std::to_string(i));
+        result.push_back(std::move(f));
+    }
+    return result;
+}
+
+inline feature_collection makeProperties(std::size_t count, std::size_t properties) {
+    generator rng;
+    feature_collection result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        feature f{ point{ rng.next(-180, 180), rng.next(-85, 85) } };
+        f.id = std::string("feature-") + std::to_string(i);
+        for (std::size_t p = 0; p < properties; ++p) {
+            const std::string key = "property_" + std::to_string(p);
+            switch (p % 5) {
+            case 0:
+                f.properties.emplace(key, std::string("value ") + std::to_string(i * p));
+                break;
+            case 1:
+                f.properties.emplace(key, std::int64_t(i * p) - 1000);
+                break;
+            case 2:
+                f.properties.emplace(key, rng.next(0, 1000));
+                break;
+            case 3:
+                f.properties.emplace(key, p % 2 == 0);
+                break;
+            default:
+                f.properties.emplace(
+                    key, value::array_type{ std::uint64_t(p), std::string("tag"),
+                                            value::object_type{ { "level", std::uint64_t(i % 7) },
+                                                                { "visible", true } } });
+                break;
+            }
+        }
+        result.push_back(std::move(f));
+    }
+    return result;
+}
+
+inline feature_collection makeCollections(std::size_t count, std::size_t depth) {
+    generator rng;
+    feature_collection result;
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        geometry nested{ line_string{ { rng.next(-180, 180), rng.next(-85, 85) },
+                                      { rng.next(-180, 180), rng.next(-85, 85) } } };
+        for (std::size_t d = 0; d < depth; ++d) {
+            nested = geometry_collection{ point{ rng.next(-180, 180), rng.next(-85, 85) },
+                                          std::move(nested) };
+        }
+        result.emplace_back(std::move(nested));
+    }
+    return result;
+}
+
+// The generated collection together with its serialization.
+struct sample {
+    feature_collection features;
+    std::string json;
+};
+
+inline sample make(dataset kind) {
+    sample result;
+    switch (kind) {
+    case dataset::Points:
+        result.features = makePoints(100000);
+        break;
+    case dataset::Polygons:
+        result.features = makePolygons(10, 100000);
+        break;
+    case dataset::Properties:
+        result.features = makeProperties(10000, 50);
+        break;
+    case dataset::Collections:
+        result.features = makeCollections(1000, 64);
+        break;
+    }
+    result.json = stringify(geojson{ result.features });
+    return result;
+}
+
+} // namespace bench
@@ -4,6 +4,11 @@
 #include <mapbox/feature.hpp>
 #include <mapbox/variant.hpp>
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
 namespace mapbox {
 namespace geojson {
 
@@ -29,10 +34,84 @@ using feature_collection  = mapbox::feature::feature_collection<double>;
 template <class T>
 T parse(const std::string &);
 
-// Parse any GeoJSON type.
+// Parse any GeoJSON type. Numbers are converted by rapidjson as it reads the document; the
+// faster coordinate conversion of parse(json, parse_options) is not used.
 using geojson = mapbox::util::variant<geometry, feature, feature_collection>;
 geojson parse(const std::string &);
 
+// Transforms positions in place. Positions are passed in contiguous runs: the positions of one
+// line string, ring or multi point, or a single point.
+using transform_function = std::function<void(point *, std::size_t)>;
+
+// Caps on the size of parsed input. They are checked as the input is read, so oversized input is
+// rejected as soon as a limit is crossed. 0 means unlimited.
+struct parse_limits {
+    // Length of the JSON text.
+    std::size_t max_input_bytes = 0;
+    // Nesting of JSON arrays and objects, counting the outermost one.
+    std::size_t max_depth = 0;
+    // Coordinate values, so a two dimensional position counts two. Geometry limits apply to each
+    // coordinates member, feature limits to each feature.
+    std::size_t max_geometry_coordinates = 0;
+    std::size_t max_feature_coordinates = 0;
+    std::size_t max_document_coordinates = 0;
+    // Members of a feature's properties object.
+    std::size_t max_properties = 0;
+    // Length of any string or member name.
+    std::size_t max_string_length = 0;
+};
+
+// Thrown when input exceeds one of the parse_limits.
+class limit_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class feature_filter;
+
+// Reductions applied to coordinates while they are being parsed, so reduced geometries are built
+// directly instead of from a full resolution copy.
+struct parse_options {
+    enum class simplification { douglas_peucker, visvalingam };
+
+    // Applied to coordinates before snapping and simplification. Empty leaves them unchanged.
+    transform_function transform;
+
+    // Snap coordinates to multiples of this spacing, dropping consecutive positions of lines and
+    // rings that collapse onto each other. 0 disables snapping.
+    double grid = 0;
+
+    // Simplify lines and rings. Douglas-Peucker drops vertices closer than tolerance to the
+    // simplified line; Visvalingam drops vertices whose effective triangle area is less than
+    // tolerance squared. Lines left with fewer than 2 positions and rings left with fewer than 4
+    // are dropped, along with the holes of a dropped outer ring. A geometry left without lines or
+    // rings is null, and is left out of a GeometryCollection. 0 disables simplification.
+    double tolerance = 0;
+    simplification algorithm = simplification::douglas_peucker;
+
+    // Convert coordinates exactly. When false, coordinates that cannot be converted with a single
+    // correctly rounded operation are approximated to within a few units in the last place
+    // instead of taking the slower exact path. Either way coordinates skip rapidjson's number
+    // conversion, which parse(json) and convert() of a rapidjson document still use.
+    bool full_precision = true;
+
+    // Skip the checks that only reject malformed input: position, line string and ring lengths,
+    // and the members features must have. For input known to be valid, such as the output of
+    // stringify. Malformed input still parses without crashing, into unspecified geometries.
+    bool trusted = false;
+
+    parse_limits limits;
+
+    // Keeps only the features of FeatureCollections that the filter accepts (see
+    // geojson/filter.hpp). A Feature document is returned whether or not the filter accepts it,
+    // though push_parser and ingest leave out one it rejects.
+    // Null keeps every feature.
+    std::shared_ptr<const feature_filter> filter;
+};
+
+// Parse any GeoJSON type, applying the given reductions.
+geojson parse(const std::string &, const parse_options &);
+
 // Stringify inputs of known types. Instantiations are provided for geometry, feature, and
 // feature_collection.
 template <class T>
@@ -41,5 +120,22 @@ std::string stringify(const T &);
 // Stringify any GeoJSON type.
 std::string stringify(const geojson &);
 
+struct stringify_options {
+    // Applied to a copy of each run of coordinates before it is written. Empty leaves them
+    // unchanged.
+    transform_function transform;
+
+    // Round coordinates to this many decimal places (at most 17), omitting trailing zeros.
+    // Negative writes the shortest representation that parses back to the same value.
+    int decimal_places = -1;
+
+    // Write the features of a collection in Hilbert order (see hilbert_sort) instead of the
+    // order they are stored in.
+    bool spatial_order = false;
+};
+
+// Stringify any GeoJSON type with the given options.
+std::string stringify(const geojson &, const stringify_options &);
+
 } // namespace geojson
 } // namespace mapbox
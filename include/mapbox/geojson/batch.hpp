@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+namespace batch_detail {
+class pool;
+} // namespace batch_detail
+
+// The outcome of parsing one document of a batch.
+struct batch_result {
+    geojson parsed;
+    // Null when the document parsed; otherwise the exception parse would have thrown.
+    std::exception_ptr failure;
+
+    bool ok() const {
+        return !failure;
+    }
+};
+
+// Parses batches of independent documents on a pool of worker threads. The threads, and the
+// parser state each of them keeps between documents, live as long as the batch_parser.
+//
+// Only built into the library when it is compiled with MAPBOX_GEOJSON_BATCH defined to 1.
+class batch_parser {
+public:
+    // Zero threads uses one per hardware thread.
+    explicit batch_parser(std::size_t threads = 0, const parse_options & = parse_options{});
+    ~batch_parser();
+
+    batch_parser(const batch_parser &) = delete;
+    batch_parser &operator=(const batch_parser &) = delete;
+
+    std::size_t threads() const;
+
+    // Results are in the order of the inputs. Batches submitted from several threads at once are
+    // parsed one after another.
+    std::vector<batch_result> parse(const std::string *inputs, std::size_t count);
+    std::vector<batch_result> parse(const std::vector<std::string> &inputs) {
+        return parse(inputs.data(), inputs.size());
+    }
+
+private:
+    std::unique_ptr<batch_detail::pool> pool_;
+};
+
+} // namespace geojson
+} // namespace mapbox
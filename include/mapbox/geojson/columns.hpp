@@ -0,0 +1,130 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// The type shared by a property's values across a feature collection. Unsigned and signed
+// integers share Int when the unsigned ones fit; integers and doubles share Double when every
+// integer converts exactly. Other combinations, arrays and objects are Mixed. The types that
+// were converted are remembered, so values come back from get() as they were in the features.
+enum class column_type { Null, Bool, Uint, Int, Double, String, Mixed };
+
+// One property of every feature of a collection, stored in an array of the column's type and
+// indexed by feature.
+class property_column {
+public:
+    enum class cell : std::uint8_t { Missing, Null, Set };
+
+    const std::string &name() const {
+        return name_;
+    }
+    column_type type() const {
+        return type_;
+    }
+    std::size_t size() const {
+        return cells_.size();
+    }
+
+    // Whether each feature has the property, and whether its value is null.
+    const std::vector<cell> &cells() const {
+        return cells_;
+    }
+    bool contains(std::size_t index) const {
+        return cells_[index] != cell::Missing;
+    }
+
+    // The feature's value, with the type it had in the feature; null when it has none.
+    value get(std::size_t index) const;
+
+    // The values converted to the column's type, of which only the array of that type is
+    // filled. Features without a value hold false, zero or an empty string.
+    const std::vector<std::uint8_t> &bools() const {
+        return bools_;
+    }
+    const std::vector<std::uint64_t> &uints() const {
+        return uints_;
+    }
+    const std::vector<std::int64_t> &ints() const {
+        return ints_;
+    }
+    const std::vector<double> &doubles() const {
+        return doubles_;
+    }
+    const std::vector<std::string> &strings() const {
+        return strings_;
+    }
+    const std::vector<value> &values() const {
+        return values_;
+    }
+
+private:
+    friend class property_table;
+
+    // The type a value of an Int or Double column had before it was converted.
+    enum class value_kind : std::uint8_t { Column, Uint, Int };
+
+    std::string name_;
+    column_type type_ = column_type::Null;
+    std::vector<cell> cells_;
+    // Empty unless the column converted some of its values.
+    std::vector<std::uint8_t> kinds_;
+    std::vector<std::uint8_t> bools_;
+    std::vector<std::uint64_t> uints_;
+    std::vector<std::int64_t> ints_;
+    std::vector<double> doubles_;
+    std::vector<std::string> strings_;
+    std::vector<value> values_;
+};
+
+// The properties of a feature collection as one typed column per property name, with the
+// schema inferred from the values of all features. Filtering and aggregating a property then
+// runs over a contiguous array instead of looking it up in each feature's map.
+class property_table {
+public:
+    property_table() = default;
+    explicit property_table(const feature_collection &);
+
+    // Number of features.
+    std::size_t size() const {
+        return size_;
+    }
+
+    // Sorted by name.
+    const std::vector<property_column> &columns() const {
+        return columns_;
+    }
+
+    // Null when no feature has the property.
+    const property_column *find(const std::string &name) const;
+
+    // The feature's value of a property; null when it has none.
+    value get(std::size_t index, const std::string &name) const;
+
+    // The feature's properties as a map, equal to the one the table was built from.
+    value::object_type properties(std::size_t index) const;
+
+    std::size_t memory_usage() const;
+
+private:
+    friend property_table take_properties(feature_collection &);
+
+    // Copies the properties of a const collection and moves those of a mutable one.
+    template <class Collection>
+    void build(Collection &);
+
+    std::size_t size_ = 0;
+    std::vector<property_column> columns_;
+};
+
+// Moves the properties of the features into a table, leaving their property maps empty.
+property_table take_properties(feature_collection &);
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <mapbox/geojson/memory.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions so that allocation_counter sees every allocation.
+// Include this in exactly one translation unit of the program. Each block is prefixed with its
+// size, so deallocations can be subtracted from the live total. Every form of operator new and
+// delete is replaced, so no block reaches a delete that doesn't know about the prefix.
+
+namespace mapbox {
+namespace geojson {
+namespace detail {
+
+constexpr std::size_t allocation_header = alignof(std::max_align_t);
+
+// Allocates size bytes after a header of the given size, which is a multiple of the alignment.
+inline void *allocateCounted(std::size_t size, std::size_t header, std::size_t alignment) noexcept {
+    char *block;
+    if (alignment <= allocation_header) {
+        block = static_cast<char *>(std::malloc(size + header));
+    } else {
+        void *aligned = nullptr;
+        if (posix_memalign(&aligned, alignment, size + header) != 0) {
+            return nullptr;
+        }
+        block = static_cast<char *>(aligned);
+    }
+    if (!block) {
+        return nullptr;
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    allocation_counter::allocated(size);
+    return block + header;
+}
+
+inline void freeCounted(void *ptr, std::size_t header) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto *block = static_cast<char *>(ptr) - header;
+    allocation_counter::deallocated(*reinterpret_cast<std::size_t *>(block));
+    std::free(block);
+}
+
+// Retries through the new handler as the standard operator new does.
+inline void *allocateOrThrow(std::size_t size, std::size_t header, std::size_t alignment) {
+    for (;;) {
+        if (void *ptr = allocateCounted(size, header, alignment)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void *allocateOrNull(std::size_t size, std::size_t header, std::size_t alignment) noexcept {
+    try {
+        return allocateOrThrow(size, header, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace detail
+} // namespace geojson
+} // namespace mapbox
+
+void *operator new(std::size_t size) {
+    using namespace mapbox::geojson::detail;
+    return allocateOrThrow(size, allocation_header, allocation_header);
+}
+
+void *operator new[](std::size_t size) {
+    using namespace mapbox::geojson::detail;
+    return allocateOrThrow(size, allocation_header, allocation_header);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    return allocateOrNull(size, allocation_header, allocation_header);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    return allocateOrNull(size, allocation_header, allocation_header);
+}
+
+void operator delete(void *ptr) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+void operator delete[](void *ptr) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, allocation_header);
+}
+
+#if defined(__cpp_aligned_new)
+
+// Over-aligned blocks put the header in a prefix as large as the alignment, so the block that
+// follows keeps it.
+namespace mapbox {
+namespace geojson {
+namespace detail {
+
+inline std::size_t alignedHeader(std::align_val_t alignment) noexcept {
+    const auto value = static_cast<std::size_t>(alignment);
+    return value > allocation_header ? value : allocation_header;
+}
+
+} // namespace detail
+} // namespace geojson
+} // namespace mapbox
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    using namespace mapbox::geojson::detail;
+    return allocateOrThrow(size, alignedHeader(alignment), static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    using namespace mapbox::geojson::detail;
+    return allocateOrThrow(size, alignedHeader(alignment), static_cast<std::size_t>(alignment));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    return allocateOrNull(size, alignedHeader(alignment), static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    return allocateOrNull(size, alignedHeader(alignment), static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr, std::align_val_t alignment) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t alignment) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t alignment) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    using namespace mapbox::geojson::detail;
+    freeCounted(ptr, alignedHeader(alignment));
+}
+
+#endif
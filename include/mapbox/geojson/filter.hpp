@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/visitor.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mapbox {
+namespace geojson {
+
+namespace filter_detail {
+struct program;
+} // namespace filter_detail
+
+// A condition on a feature's properties and geometry type, compiled once from an expression
+// such as
+//
+//   highway in (primary, secondary) and lanes >= 2 and $type != "Point"
+//
+// Comparisons are ==, !=, <, <=, > and >=, between property names, $type and literals: decimal
+// numbers as JSON writes them, 'single' or "double" quoted strings, true, false and null.
+// Properties a feature lacks are null, as is the $type of a feature without a geometry. "in" and
+// "not in" test membership in a list of literals, where unquoted words are strings. Conditions
+// combine with and, or, not and parentheses, also written &&, || and !.
+//
+// Numbers compare by value whatever their type, and strings in byte order. Values of different
+// types are unequal and unordered, so only != holds between them.
+//
+// Set as parse_options::filter, it is evaluated while a FeatureCollection is parsed. Features it
+// rejects are left out, and their geometries are not built.
+class feature_filter {
+public:
+    // Throws std::runtime_error for expressions that don't compile.
+    explicit feature_filter(const std::string &expression);
+
+    bool uses_geometry_type() const;
+
+    // The geometry type is null for features without a geometry.
+    bool evaluate(const value::object_type &properties, const geometry_type *) const;
+    bool operator()(const feature &) const;
+
+private:
+    std::shared_ptr<const filter_detail::program> program_;
+};
+
+} // namespace geojson
+} // namespace mapbox
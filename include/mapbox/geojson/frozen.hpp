@@ -0,0 +1,187 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/visitor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mapbox {
+namespace geojson {
+
+namespace frozen_detail {
+struct sections;
+} // namespace frozen_detail
+
+// Read-only views into a frozen_feature_collection. They stay valid while the collection they
+// came from is alive, including after it has been moved.
+
+// Positions stored next to each other.
+class point_span {
+public:
+    point_span(const point *data, std::size_t size) : data_(data), size_(size) {
+    }
+
+    const point *begin() const {
+        return data_;
+    }
+    const point *end() const {
+        return data_ + size_;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+    const point &operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+private:
+    const point *data_;
+    std::size_t size_;
+};
+
+class frozen_string {
+public:
+    frozen_string(const char *data, std::size_t size) : data_(data), size_(size) {
+    }
+
+    const char *data() const {
+        return data_;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+    std::string str() const {
+        return { data_, size_ };
+    }
+    bool operator==(const std::string &other) const {
+        return other.compare(0, other.size(), data_, size_) == 0;
+    }
+
+private:
+    const char *data_;
+    std::size_t size_;
+};
+
+class frozen_value {
+public:
+    enum class kind { Null, Bool, Uint, Int, Double, String, Array, Object };
+
+    kind type() const;
+    bool get_bool() const;
+    std::uint64_t get_uint() const;
+    std::int64_t get_int() const;
+    double get_double() const;
+    frozen_string get_string() const;
+
+    // Elements of an array, or members of an object. Members are sorted by key.
+    std::size_t size() const;
+    frozen_value operator[](std::size_t) const;
+    frozen_string key(std::size_t) const;
+
+    // Index of the member with the given key, or size() if there is none or this isn't an object.
+    std::size_t find(const std::string &) const;
+    // Value of the member with the given key; throws std::out_of_range if there is none.
+    frozen_value at(const std::string &) const;
+
+    value thaw() const;
+
+private:
+    friend class frozen_feature;
+    frozen_value(const frozen_detail::sections *sections, std::size_t index)
+        : sections_(sections), index_(index) {
+    }
+
+    const frozen_detail::sections *sections_;
+    std::size_t index_;
+};
+
+class frozen_geometry {
+public:
+    // True for a null geometry, which has no type.
+    bool empty() const;
+    geometry_type type() const;
+
+    // The position of a Point, or the positions of a MultiPoint or LineString.
+    point_span points() const;
+
+    // Rings of a Polygon, lines of a MultiLineString, polygons of a MultiPolygon, or members of
+    // a GeometryCollection.
+    std::size_t size() const;
+    // The ith ring of a Polygon or line of a MultiLineString.
+    point_span part(std::size_t) const;
+    // The ith polygon of a MultiPolygon or member of a GeometryCollection.
+    frozen_geometry operator[](std::size_t) const;
+
+    mapbox::geojson::geometry thaw() const;
+
+private:
+    friend class frozen_feature;
+    frozen_geometry(const frozen_detail::sections *sections, std::size_t index)
+        : sections_(sections), index_(index) {
+    }
+
+    const frozen_detail::sections *sections_;
+    std::size_t index_;
+};
+
+class frozen_feature {
+public:
+    frozen_geometry geometry() const;
+    // Null when the feature has no id.
+    frozen_value id() const;
+    // An object value.
+    frozen_value properties() const;
+
+    feature thaw() const;
+
+private:
+    friend class frozen_feature_collection;
+    frozen_feature(const frozen_detail::sections *sections, std::size_t index)
+        : sections_(sections), index_(index) {
+    }
+
+    const frozen_detail::sections *sections_;
+    std::size_t index_;
+};
+
+// A feature collection stored in a single read-only block of memory: positions, strings and
+// properties of all features are packed next to each other, with nothing left over for growth.
+class frozen_feature_collection {
+public:
+    frozen_feature_collection();
+    explicit frozen_feature_collection(const feature_collection &);
+
+    std::size_t size() const;
+    bool empty() const {
+        return size() == 0;
+    }
+    frozen_feature operator[](std::size_t) const;
+
+    // Size of the block.
+    std::size_t memory_usage() const {
+        return bytes_;
+    }
+
+    feature_collection thaw() const;
+
+private:
+    const frozen_detail::sections *sections() const;
+
+    std::unique_ptr<char[]> arena_;
+    std::size_t bytes_ = 0;
+};
+
+// Moves a collection into a frozen_feature_collection, releasing the memory it held.
+frozen_feature_collection freeze(feature_collection &&);
+
+// Releases the unused capacity of every container in a collection, keeping its types.
+void shrink_to_fit(feature_collection &);
+
+} // namespace geojson
+} // namespace mapbox
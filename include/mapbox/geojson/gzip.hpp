@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/visitor.hpp>
+
+#include <istream>
+#include <ostream>
+
+namespace mapbox {
+namespace geojson {
+
+// Compressed input and output, backed by zlib. Text is decompressed and compressed in fixed-size
+// blocks while it is parsed or written, so the uncompressed document is never held in memory.
+//
+// Only built into the library when it is compiled with MAPBOX_GEOJSON_GZIP defined to 1;
+// programs using it link with zlib.
+
+// Parse gzip or zlib compressed GeoJSON from a stream. max_input_bytes limits the size of the
+// decompressed text.
+geojson parse_gzip(std::istream &, const parse_options & = parse_options{});
+
+// Parse gzip or zlib compressed GeoJSON from a stream, passing its events to a visitor.
+void parse_gzip(std::istream &, visitor &);
+
+// Write GeoJSON to a stream as gzip. The level is passed to zlib: 1 to 9, or -1 for its default.
+void stringify_gzip(const geojson &,
+                    std::ostream &,
+                    const stringify_options & = stringify_options{},
+                    int level = -1);
+
+} // namespace geojson
+} // namespace mapbox
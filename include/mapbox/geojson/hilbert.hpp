@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Orders features along a Hilbert curve through the centers of their bounding boxes, so features
+// that are near each other in space end up near each other in the collection. Features without
+// positions go last. Features with the same key keep their relative order.
+//
+// Keys are computed and sorted on the given number of threads; zero uses one per hardware
+// thread.
+
+// The order as indices into the collection.
+std::vector<std::size_t> hilbert_order(const feature_collection &, std::size_t threads = 0);
+
+// Reorders the collection in place.
+void hilbert_sort(feature_collection &, std::size_t threads = 0);
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Finds features of a collection by id in constant time. Ids are compared as identifier
+// compares them, so 1, -1, 1.0 and "1" are four different ids. Null and NaN ids are not indexed.
+//
+// Ids are kept in an open addressing hash table of fixed size slots: numbers are stored in the
+// slot, and strings in one shared buffer that the slot points into. The index does not refer to
+// the collection, so it must be updated along with it.
+class id_index {
+public:
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    id_index() = default;
+
+    // Ids are hashed and copied on up to the given number of threads, zero meaning one per
+    // hardware thread. When several features share an id, the first one is indexed.
+    explicit id_index(const feature_collection &, std::size_t threads = 0);
+
+    // The index of the feature with this id, or npos.
+    std::size_t find(const identifier &) const;
+
+    // Points the id at a feature, adding it if it isn't indexed yet.
+    void insert(const identifier &, std::size_t index);
+
+    // Returns whether the id was indexed. The space of erased string ids is reused only when
+    // the index is rebuilt.
+    bool erase(const identifier &);
+
+    // Number of ids indexed.
+    std::size_t size() const {
+        return size_;
+    }
+
+    std::size_t memory_usage() const;
+
+private:
+    struct slot {
+        // The hash of the id, and its bits or the offset of its string.
+        std::uint64_t hash;
+        std::uint64_t payload;
+        std::uint32_t index;
+        std::uint8_t kind;
+    };
+
+    // Fills in a slot for the id, without a string offset. False for ids that aren't indexed.
+    static bool describe(const identifier &, slot &);
+
+    std::size_t locate(const slot &, const std::string *) const;
+    std::size_t appendString(const std::string &);
+    bool sameString(std::uint64_t offset, const std::string &) const;
+    void place(const slot &);
+    void reserve(std::size_t count);
+
+    std::vector<slot> slots_;
+    std::string strings_;
+    std::size_t size_ = 0;
+};
+
+} // namespace geojson
+} // namespace mapbox
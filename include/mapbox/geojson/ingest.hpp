@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+struct ingest_options {
+    parse_options parsing;
+
+    // Zero uses one thread per hardware thread.
+    std::size_t threads = 0;
+
+    // FeatureCollections larger than this, with their type member before their features, are
+    // split into units of about this many bytes of features, so several threads can work on one
+    // file.
+    std::size_t unit_bytes = 1 << 20;
+};
+
+// Receives the index of a file, the index of a feature within it, and the feature. Called from
+// several threads at once, in no particular order. Features that parsing.filter rejects are not
+// passed, and the others keep their index.
+using ingest_callback = std::function<void(std::size_t file, std::size_t index, feature &&)>;
+
+// Parses files of GeoJSON in parallel, passing their features to the callback. Each file must be
+// a FeatureCollection or a Feature. Files are mapped into memory rather than read, and the work
+// is balanced between threads by work stealing. Only built into the library when it is compiled
+// with MAPBOX_GEOJSON_INGEST defined to 1, on POSIX systems.
+//
+// parsing.limits apply to each file as in parse(), except in a FeatureCollection that is split:
+// there max_input_bytes still applies to the whole file, but the other limits, including
+// max_document_coordinates, apply to each feature separately, as in push_parser.
+//
+// Returns an entry for each file: null, or the exception that stopped it. The callback throwing
+// stops its file too. Features of a file that fails may have been passed on before the failure
+// was found.
+std::vector<std::exception_ptr>
+ingest(const std::vector<std::string> &paths, const ingest_callback &, const ingest_options & = ingest_options{});
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+// Phase timing adds a thread local check to each geometry and feature conversion. Build the
+// library with MAPBOX_GEOJSON_INSTRUMENTATION defined to 0 to compile it out; the stats overloads
+// then report counts and total time only.
+#ifndef MAPBOX_GEOJSON_INSTRUMENTATION
+#define MAPBOX_GEOJSON_INSTRUMENTATION 1
+#endif
+
+namespace mapbox {
+namespace geojson {
+
+struct instrumentation_stats {
+    // Time spent reading the JSON text into a document (parse only), converting geometries
+    // including their validation, converting feature ids and properties, and writing the JSON
+    // text (stringify only).
+    std::chrono::nanoseconds tokenize_time{ 0 };
+    std::chrono::nanoseconds geometry_time{ 0 };
+    std::chrono::nanoseconds property_time{ 0 };
+    std::chrono::nanoseconds write_time{ 0 };
+    std::chrono::nanoseconds total_time{ 0 };
+
+    // Length of the JSON text read or written.
+    std::size_t bytes = 0;
+    std::size_t features = 0;
+    // Positions of all geometries, and members of all feature properties objects.
+    std::size_t vertices = 0;
+    std::size_t properties = 0;
+};
+
+// Receives each instrumented parse and stringify, for example to forward them as trace spans.
+// Phases interleave feature by feature, so their times are totals rather than intervals.
+class instrumentation_hook {
+public:
+    virtual ~instrumentation_hook() = default;
+
+    virtual void begin_parse() {
+    }
+    virtual void end_parse(const instrumentation_stats &) {
+    }
+
+    virtual void begin_stringify() {
+    }
+    virtual void end_stringify(const instrumentation_stats &) {
+    }
+};
+
+// Parse any GeoJSON type, filling stats and reporting to hook if one is given. Stats are filled
+// for failed parses too, as far as they got, before the error is thrown.
+geojson parse(const std::string &, instrumentation_stats &, instrumentation_hook * = nullptr);
+
+// Stringify any GeoJSON type, filling stats and reporting to hook if one is given.
+std::string stringify(const geojson &, instrumentation_stats &, instrumentation_hook * = nullptr);
+
+} // namespace geojson
+} // namespace mapbox
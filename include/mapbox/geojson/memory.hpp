@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace mapbox {
+namespace geojson {
+
+// Heap bytes owned by an object: the capacity of its vectors, strings too long to be stored
+// inline, and its property maps. The object itself and allocator overhead are not counted, and
+// hash map buckets and nodes are estimated from the usual standard library layout.
+std::size_t memory_usage(const geometry &);
+std::size_t memory_usage(const feature &);
+std::size_t memory_usage(const feature_collection &);
+std::size_t memory_usage(const value &);
+std::size_t memory_usage(const geojson &);
+
+struct allocation_stats {
+    // Calls to operator new and the bytes they requested.
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    // Largest number of bytes live at once, counted from when counting started.
+    std::size_t peak_bytes = 0;
+};
+
+// Counts the heap allocations made by the current thread while it is alive. Counters nest; an
+// inner counter's allocations are also counted by the outer one.
+//
+// Counting relies on the operator new and delete replacements in
+// <mapbox/geojson/count_allocations.hpp>, which must be included in exactly one translation unit
+// of the program. Without them the stats stay zero.
+class allocation_counter {
+public:
+    allocation_counter();
+    ~allocation_counter();
+
+    allocation_counter(const allocation_counter &) = delete;
+    allocation_counter &operator=(const allocation_counter &) = delete;
+
+    const allocation_stats &stats() const {
+        return stats_;
+    }
+
+    // Called by the replacements for every allocation and deallocation.
+    static void allocated(std::size_t) noexcept;
+    static void deallocated(std::size_t) noexcept;
+
+private:
+    allocation_counter *previous_;
+    allocation_stats stats_;
+    // Frees of blocks allocated before counting started make this negative.
+    std::ptrdiff_t live_ = 0;
+};
+
+// Parse any GeoJSON type like parse(json, options), counting the allocations made, including
+// those owned by the result.
+geojson parse(const std::string &, const parse_options &, allocation_stats &);
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+
+namespace mapbox {
+namespace geojson {
+
+// Projects longitude/latitude degrees to Web Mercator meters (EPSG:3857) in place. Latitudes
+// are clamped to the Mercator limit of about 85.05 degrees. Usable as a transform_function.
+void lonlat_to_mercator(point *, std::size_t);
+
+// Inverse of lonlat_to_mercator.
+void mercator_to_lonlat(point *, std::size_t);
+
+} // namespace geojson
+} // namespace mapbox
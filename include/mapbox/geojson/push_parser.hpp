@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/scanner.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Parses GeoJSON that arrives in chunks, such as a request body read from a socket. Chunks may
+// end anywhere, including inside a string or number.
+//
+// The features of a FeatureCollection are passed to the callback as soon as each one is
+// complete, and only the text of the feature in progress is kept, so memory use is bounded by
+// the largest feature rather than the whole document. This needs the type member to come before
+// the features. Any other document is kept until finish() and then parsed at once; a Feature is
+// passed to the callback, other types are rejected.
+//
+// Features are parsed with the given options. Limits apply to each feature separately, except
+// max_input_bytes, which applies to all of the input. After an error is thrown the parser can't
+// be used again.
+class push_parser {
+public:
+    using feature_callback = std::function<void(feature &&)>;
+
+    // A max_buffer_bytes other than 0 caps the text kept at once, and so the size of a single
+    // feature; exceeding it throws limit_error.
+    explicit push_parser(feature_callback,
+                         const parse_options & = parse_options{},
+                         std::size_t max_buffer_bytes = 0);
+
+    void feed(const char *data, std::size_t size);
+    void feed(const std::string &chunk) {
+        feed(chunk.data(), chunk.size());
+    }
+
+    // Checks that the document is complete and passes on what remains of it.
+    void finish();
+
+    // Bytes currently kept.
+    std::size_t buffered() const {
+        return buffer_.size();
+    }
+
+private:
+    void parseFeatures();
+    void compact();
+
+    feature_callback callback_;
+    parse_options options_;
+    std::size_t maxBuffer_;
+
+    // Text from offset base_ of the input on.
+    std::string buffer_;
+    std::size_t base_ = 0;
+
+    features_scanner scanner_;
+    std::vector<features_scanner::range> features_;
+};
+
+} // namespace geojson
+} // namespace mapbox
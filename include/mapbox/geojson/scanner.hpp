@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Finds where the features of a FeatureCollection start and end, without parsing them. The text
+// may be scanned in pieces that end anywhere. Within a feature only strings and nesting are
+// tracked, since the feature is parsed afterwards; the rest of the document is checked against
+// the JSON grammar.
+//
+// Features are only found once the type member has been read as FeatureCollection. A features
+// member that comes before the type, or belongs to another type, is left to a parse of the whole
+// document. As in parse(), the first type member counts.
+class features_scanner {
+public:
+    // Offsets from the start of the text; end is one past the closing brace.
+    struct range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // Scans the next piece of the text, appending the features it completes. Throws on text
+    // that can't be a FeatureCollection.
+    void scan(const char *data, std::size_t size, std::vector<range> &features);
+
+    // Whether the features of a FeatureCollection have been found.
+    bool found() const {
+        return sawFeatures_;
+    }
+    // Whether the outermost object has been closed.
+    bool ended() const {
+        return ended_;
+    }
+    // Where the feature in progress starts, or std::string::npos if there is none.
+    std::size_t pending() const {
+        return featureStart_;
+    }
+    // Bytes scanned so far.
+    std::size_t offset() const {
+        return offset_;
+    }
+
+private:
+    // What may come next outside of strings, numbers and literals.
+    enum class expect : std::uint8_t { FirstKey, Key, Colon, FirstValue, Value, Next };
+
+    // Progress through a number, following the JSON grammar.
+    enum class number : std::uint8_t {
+        None,
+        Minus,
+        Zero,
+        Integer,
+        Point,
+        Fraction,
+        Exponent,
+        ExponentSign,
+        ExponentDigits
+    };
+
+    void scanValue(char c);
+    void scanFeature(char c, std::vector<range> &features);
+    bool continueScalar(char c);
+    void append(char c);
+    void appendCodePoint();
+    void endString();
+    void close(char c);
+    [[noreturn]] void fail(const char *message) const;
+
+    std::size_t offset_ = 0;
+    bool inString_      = false;
+    bool escaped_       = false;
+    // Hex digits left of a \u escape, and its code point so far.
+    int hexDigits_      = 0;
+    unsigned codePoint_ = 0;
+    bool started_       = false;
+    bool ended_         = false;
+
+    // The open objects and arrays outside of features, as '{' and '['.
+    std::string containers_;
+    expect expect_ = expect::FirstKey;
+    bool stringIsKey_ = false;
+    number number_    = number::None;
+    // The rest of the true, false or null literal being read.
+    const char *literal_ = nullptr;
+
+    // Members of the outermost object: the key being read, the last key, and the value of
+    // "type". Escapes are decoded, so they compare as parse() sees them.
+    bool capturing_ = false;
+    std::string token_;
+    std::string key_;
+    std::string type_;
+    bool sawType_ = false;
+
+    // Whether a features member has been seen, and whether its features are being found.
+    bool sawMember_           = false;
+    bool inFeatures_          = false;
+    bool sawFeatures_         = false;
+    std::size_t featureDepth_ = 0;
+    std::size_t featureStart_ = std::string::npos;
+};
+
+} // namespace geojson
+} // namespace mapbox
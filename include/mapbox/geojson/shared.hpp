@@ -0,0 +1,128 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+namespace shared_detail {
+
+// A reference counted block holding a T. std::shared_ptr can't tell whether it is the only owner
+// of a block without racing: use_count() is a relaxed load, which doesn't order the last reads
+// of an owner on another thread before a write here. unique() loads the count with acquire
+// ordering, pairing with the release of owners that let go of the block.
+template <class T>
+class shared_block {
+public:
+    explicit shared_block(T v) : block_(new block(std::move(v))) {
+    }
+    shared_block(const shared_block &other) noexcept : block_(other.block_) {
+        block_->owners.fetch_add(1, std::memory_order_relaxed);
+    }
+    shared_block(shared_block &&other) noexcept : block_(other.block_) {
+        other.block_ = nullptr;
+    }
+    shared_block &operator=(shared_block other) noexcept {
+        std::swap(block_, other.block_);
+        return *this;
+    }
+    ~shared_block() {
+        if (block_ && block_->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block_;
+        }
+    }
+
+    const T &operator*() const {
+        return block_->data;
+    }
+    T &operator*() {
+        return block_->data;
+    }
+
+    bool unique() const {
+        return block_->owners.load(std::memory_order_acquire) == 1;
+    }
+    bool operator==(const shared_block &other) const {
+        return block_ == other.block_;
+    }
+
+private:
+    struct block {
+        explicit block(T v) : data(std::move(v)) {
+        }
+        T data;
+        std::atomic<std::size_t> owners{ 1 };
+    };
+
+    block *block_;
+};
+
+} // namespace shared_detail
+
+// A feature whose geometry and properties are held by reference counted blocks. Copies share the
+// blocks instead of copying them, so features can be kept and passed between threads cheaply.
+// The blocks are immutable while shared: the mutable accessors copy a block first unless this is
+// its only owner.
+//
+// Like the standard containers, a shared_feature may be read from many threads at once, but must
+// not be modified while another thread uses the same shared_feature object.
+class shared_feature {
+public:
+    using property_map = value::object_type;
+
+    shared_feature();
+    explicit shared_feature(feature &&);
+    explicit shared_feature(const feature &);
+
+    const mapbox::geojson::geometry &geometry() const {
+        return *geometry_;
+    }
+    const property_map &properties() const {
+        return *properties_;
+    }
+    const identifier &id() const {
+        return id_;
+    }
+
+    mapbox::geojson::geometry &mutable_geometry();
+    property_map &mutable_properties();
+    void set_id(identifier newId) {
+        id_ = std::move(newId);
+    }
+
+    // Whether the blocks are shared with the given feature.
+    bool shares_geometry(const shared_feature &other) const {
+        return geometry_ == other.geometry_;
+    }
+    bool shares_properties(const shared_feature &other) const {
+        return properties_ == other.properties_;
+    }
+
+    // A deep copy as a plain feature.
+    feature to_feature() const;
+
+private:
+    shared_detail::shared_block<mapbox::geojson::geometry> geometry_;
+    shared_detail::shared_block<property_map> properties_;
+    identifier id_;
+};
+
+bool operator==(const shared_feature &, const shared_feature &);
+bool operator!=(const shared_feature &, const shared_feature &);
+
+using shared_feature_collection = std::vector<shared_feature>;
+
+// Moves the contents of plain features into shared ones, and back by deep copy.
+shared_feature_collection share(feature_collection &&);
+feature_collection unshare(const shared_feature_collection &);
+
+// parse, stringify and convert (to rapidjson) instantiations are provided for shared_feature and
+// shared_feature_collection.
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+using bounding_box = mapbox::geometry::box<double>;
+
+// The bounding box of a geometry's positions. Without positions, min is greater than max.
+bounding_box compute_bounding_box(const geometry &);
+
+// Indices of the features listed in one tile, in ascending order.
+class tile_features {
+public:
+    tile_features(const std::uint32_t *data, std::size_t size) : data_(data), size_(size) {
+    }
+
+    const std::uint32_t *begin() const {
+        return data_;
+    }
+    const std::uint32_t *end() const {
+        return data_ + size_;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+    std::uint32_t operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+private:
+    const std::uint32_t *data_;
+    std::size_t size_;
+};
+
+struct tile_index_options {
+    // Zoom levels to list features at, at most 24.
+    std::uint32_t min_zoom = 0;
+    std::uint32_t max_zoom = 14;
+
+    // Zero uses one thread per hardware thread.
+    std::size_t threads = 0;
+
+    // Largest number of (tile, feature) entries to store; more throws limit_error before any of
+    // them are allocated. A feature is listed in every tile its bounding box touches, so the
+    // count grows fourfold with each zoom level: a box spanning the world needs some 358 million
+    // entries up to zoom 14. Building takes 16 bytes per entry at its peak, so the default caps
+    // it at 256 MB. Zero is unlimited.
+    std::size_t max_entries = std::size_t(1) << 24;
+};
+
+// Lists the features whose bounding boxes touch each Web Mercator tile of a range of zoom levels.
+// Positions are longitude and latitude. The index is built in one parallel pass, and the lists of
+// all tiles are stored one after another in a single array.
+class tile_index {
+public:
+    tile_index() = default;
+    explicit tile_index(const feature_collection &, const tile_index_options & = tile_index_options{});
+
+    // From the bounding boxes of features, such as ones computed while the features were parsed
+    // without keeping them. Boxes whose min is greater than their max touch no tiles.
+    explicit tile_index(const std::vector<bounding_box> &, const tile_index_options & = tile_index_options{});
+
+    // Empty for tiles outside the zoom range, and for tiles that no feature touches.
+    tile_features features(std::uint32_t z, std::uint32_t x, std::uint32_t y) const;
+
+    // Tiles that have at least one feature.
+    std::size_t tiles() const {
+        return keys_.size();
+    }
+    std::size_t entries() const {
+        return indices_.size();
+    }
+
+    std::size_t memory_usage() const;
+
+private:
+    void build(const std::vector<bounding_box> &, const tile_index_options &);
+
+    // Tiles sorted by zoom, x and y, and where each tile's features start in indices_.
+    std::vector<std::uint64_t> keys_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::uint32_t> indices_;
+};
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/visitor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Index into topology::arcs. A negative index ~i stands for arc i traversed in reverse.
+using arc_index = std::int64_t;
+
+// A line or ring, as the arcs it is made of, in order. Each arc starts at the last position of
+// the one before it.
+using arc_path = std::vector<arc_index>;
+
+// A geometry whose lines and rings refer to shared arcs.
+struct topo_geometry {
+    // True for features without a geometry; the other members are then unused.
+    bool null = true;
+    geometry_type type = geometry_type::Point;
+
+    // The position of a Point, or the positions of a MultiPoint.
+    std::vector<point> points;
+
+    // The LineString, the lines of a MultiLineString, the rings of a Polygon, or the rings of
+    // every polygon of a MultiPolygon, one polygon after another.
+    std::vector<arc_path> paths;
+
+    // Number of rings of each polygon of a MultiPolygon.
+    std::vector<std::size_t> polygon_sizes;
+
+    // Members of a GeometryCollection.
+    std::vector<topo_geometry> geometries;
+};
+
+struct topo_feature {
+    topo_geometry geometry;
+    value::object_type properties;
+    identifier id;
+};
+
+// A feature collection whose lines and rings are cut into arcs where they meet, with each arc
+// stored once however many lines and rings run along it. Boundaries shared by adjacent polygons
+// are stored once instead of twice. Features are rebuilt as GeoJSON geometries on demand.
+struct topology {
+    std::vector<line_string> arcs;
+    std::vector<topo_feature> features;
+
+    mapbox::geojson::geometry to_geometry(const topo_geometry &) const;
+    feature to_feature(std::size_t index) const;
+    feature_collection to_feature_collection() const;
+};
+
+// Finds the arcs shared between the lines and rings of the features. Lines and rings are cut
+// wherever they meet or part from another one, and at the ends of lines; rings that meet no
+// others are kept as single arcs. Rings are rebuilt starting at their first junction, or at
+// their lowest position if they have none, so they may start elsewhere than the input rings.
+topology to_topology(const feature_collection &);
+
+// Reads a TopoJSON Topology. The geometry objects of every member of "objects" become features,
+// with the members of a top level GeometryCollection object becoming one feature each. Quantized
+// topologies are decoded using their transform.
+topology parse_topology(const std::string &);
+
+// Writes a TopoJSON Topology with a single GeometryCollection object named "features", holding
+// one geometry object per feature. Positions are written unquantized.
+std::string stringify_topology(const topology &);
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/rapidjson.hpp>
+
+#include <cstddef>
+#include <iterator>
+
+namespace mapbox {
+namespace geojson {
+namespace view {
+
+// Read-only views over a parsed rapidjson document. They mirror the shape of the
+// mapbox::geometry types but read coordinates straight from the DOM instead of copying them, so
+// the document must outlive every view taken from it. Views are produced by convert<T> below,
+// which validates the input exactly like the owning conversion does.
+
+using point = mapbox::geojson::point;
+using empty = mapbox::geojson::empty;
+
+template <typename T>
+struct element {
+    static T make(const rapidjson_value &json) {
+        return T(json);
+    }
+};
+
+template <>
+struct element<point> {
+    static point make(const rapidjson_value &json) {
+        return point{ json[0].GetDouble(), json[1].GetDouble() };
+    }
+};
+
+// A range over a JSON array whose elements are presented as T. Elements are produced on
+// dereference, so iterators yield values rather than references.
+template <typename T>
+class array_view {
+public:
+    using coordinate_type = double;
+    using value_type      = T;
+    using size_type       = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = const T;
+
+        const_iterator() = default;
+        explicit const_iterator(const rapidjson_value *json) : json_(json) {
+        }
+
+        const T operator*() const {
+            return element<T>::make(*json_);
+        }
+        const T operator[](difference_type n) const {
+            return element<T>::make(json_[n]);
+        }
+
+        const_iterator &operator++() {
+            ++json_;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            return const_iterator(json_++);
+        }
+        const_iterator &operator--() {
+            --json_;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            return const_iterator(json_--);
+        }
+        const_iterator &operator+=(difference_type n) {
+            json_ += n;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type n) {
+            json_ -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const {
+            return const_iterator(json_ + n);
+        }
+        const_iterator operator-(difference_type n) const {
+            return const_iterator(json_ - n);
+        }
+        difference_type operator-(const const_iterator &other) const {
+            return json_ - other.json_;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return json_ == other.json_;
+        }
+        bool operator!=(const const_iterator &other) const {
+            return json_ != other.json_;
+        }
+        bool operator<(const const_iterator &other) const {
+            return json_ < other.json_;
+        }
+
+    private:
+        const rapidjson_value *json_ = nullptr;
+    };
+
+    using iterator = const_iterator;
+
+    explicit array_view(const rapidjson_value &json) : json_(&json) {
+    }
+
+    size_type size() const {
+        return json_->Size();
+    }
+    bool empty() const {
+        return json_->Empty();
+    }
+
+    const T operator[](size_type i) const {
+        return element<T>::make((*json_)[rapidjson::SizeType(i)]);
+    }
+    const T front() const {
+        return operator[](0);
+    }
+    const T back() const {
+        return operator[](size() - 1);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(json_->Begin());
+    }
+    const_iterator end() const {
+        return const_iterator(json_->End());
+    }
+
+    // The underlying array.
+    const rapidjson_value &json() const {
+        return *json_;
+    }
+
+private:
+    const rapidjson_value *json_;
+};
+
+struct multi_point : array_view<point> {
+    using array_view<point>::array_view;
+};
+
+struct line_string : array_view<point> {
+    using array_view<point>::array_view;
+};
+
+struct linear_ring : array_view<point> {
+    using array_view<point>::array_view;
+};
+
+struct multi_line_string : array_view<line_string> {
+    using array_view<line_string>::array_view;
+};
+
+struct polygon : array_view<linear_ring> {
+    using array_view<linear_ring>::array_view;
+};
+
+struct multi_polygon : array_view<polygon> {
+    using array_view<polygon>::array_view;
+};
+
+struct geometry;
+
+struct geometry_collection : array_view<geometry> {
+    using array_view<geometry>::array_view;
+};
+
+using geometry_base = mapbox::util::variant<empty,
+                                            point,
+                                            line_string,
+                                            polygon,
+                                            multi_point,
+                                            multi_line_string,
+                                            multi_polygon,
+                                            geometry_collection>;
+
+struct geometry : geometry_base {
+    using coordinate_type = double;
+    using geometry_base::geometry_base;
+
+    geometry() : geometry_base(empty{}) {
+    }
+};
+
+// Feature properties as stored in the document; values are left unconverted.
+class property_map {
+public:
+    using const_iterator = rapidjson_value::ConstMemberIterator;
+
+    property_map() = default;
+    explicit property_map(const rapidjson_value &json) : json_(&json) {
+    }
+
+    std::size_t size() const {
+        return json_ ? json_->MemberCount() : 0;
+    }
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Returns the member value for key, or nullptr if there is none.
+    const rapidjson_value *find(const char *key) const {
+        if (!json_) {
+            return nullptr;
+        }
+        const auto it = json_->FindMember(key);
+        return it == json_->MemberEnd() ? nullptr : &it->value;
+    }
+
+    const_iterator begin() const {
+        return json_ ? json_->MemberBegin() : const_iterator();
+    }
+    const_iterator end() const {
+        return json_ ? json_->MemberEnd() : const_iterator();
+    }
+
+private:
+    const rapidjson_value *json_ = nullptr;
+};
+
+struct feature {
+    using coordinate_type = double;
+
+    view::geometry geometry;
+    view::property_map properties;
+    identifier id;
+};
+
+template <>
+struct element<geometry> {
+    static geometry make(const rapidjson_value &json);
+};
+
+template <>
+struct element<feature> {
+    static feature make(const rapidjson_value &json);
+};
+
+struct feature_collection : array_view<feature> {
+    using array_view<feature>::array_view;
+};
+
+using geojson = mapbox::util::variant<geometry, feature, feature_collection>;
+
+} // namespace view
+
+// Convert inputs to views without copying coordinates. Instantiations are provided for
+// view::geometry, view::feature, view::feature_collection, and view::geojson.
+template <typename T>
+T convert(const rapidjson_value &);
+
+} // namespace geojson
+} // namespace mapbox
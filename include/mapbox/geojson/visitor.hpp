@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+
+namespace mapbox {
+namespace geojson {
+
+// Geometry types, named after their GeoJSON "type" values.
+enum class geometry_type {
+    Point,
+    LineString,
+    Polygon,
+    MultiPoint,
+    MultiLineString,
+    MultiPolygon,
+    GeometryCollection
+};
+
+// Receives GeoJSON content while the document is being tokenized, without building any
+// intermediate containers. Events arrive in document order and are nested as follows:
+//
+//   FeatureCollection   begin_feature_collection, features..., end_feature_collection
+//   Feature             begin_feature, [feature_id], [property..., end_properties], [geometry],
+//                       end_feature
+//   Point, MultiPoint   begin_geometry, position..., end_geometry
+//   LineString          begin_geometry, begin_line_string, position..., end_line_string,
+//                       end_geometry
+//   MultiLineString     begin_geometry, (begin_line_string ... end_line_string)..., end_geometry
+//   Polygon             begin_geometry, (begin_ring, position..., end_ring)..., end_geometry
+//   MultiPolygon        begin_geometry, (begin_polygon, rings..., end_polygon)..., end_geometry
+//   GeometryCollection  begin_geometry, geometries..., end_geometry
+//
+// The members of a feature arrive in the order they appear in. end_properties follows the last
+// property, and also an empty or null properties member. Null geometries produce no events. Members
+// that are not part of the GeoJSON structure are skipped. Coordinates that precede their geometry's
+// "type" member are buffered until the type is known; every other event is delivered as soon as it
+// has been read.
+class visitor {
+public:
+    virtual ~visitor() = default;
+
+    virtual void begin_feature_collection() {
+    }
+    virtual void end_feature_collection() {
+    }
+
+    virtual void begin_feature() {
+    }
+    virtual void end_feature() {
+    }
+    virtual void feature_id(identifier) {
+    }
+    virtual void property(std::string /* key */, value) {
+    }
+    virtual void end_properties() {
+    }
+
+    virtual void begin_geometry(geometry_type) {
+    }
+    virtual void end_geometry(geometry_type) {
+    }
+    virtual void begin_polygon() {
+    }
+    virtual void end_polygon() {
+    }
+    virtual void begin_line_string() {
+    }
+    virtual void end_line_string() {
+    }
+    virtual void begin_ring() {
+    }
+    virtual void end_ring() {
+    }
+    virtual void position(double /* x */, double /* y */) {
+    }
+};
+
+// Parse any GeoJSON type, reporting its content to the visitor. Throws on invalid input;
+// events delivered before the error was detected are not retracted.
+void parse(const std::string &, visitor &);
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <mapbox/geojson_builder_impl.hpp>
+#include <mapbox/geojson/batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace mapbox {
+namespace geojson {
+namespace batch_detail {
+
+// Workers wait for a batch, then take runs of documents from a shared counter until none are
+// left. Runs are small enough for the workers to finish close together when documents differ
+// in size.
+class pool {
+public:
+    pool(std::size_t threads, const parse_options &options) : options_(options) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        workers_.reserve(threads);
+        try {
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers_.emplace_back([this] { run(); });
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~pool() {
+        stop();
+    }
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    std::vector<batch_result> parse(const std::string *inputs, std::size_t count) {
+        std::lock_guard<std::mutex> batchLock(batch_);
+        std::vector<batch_result> results(count);
+        if (count == 0)
+            return results;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inputs_  = inputs;
+            results_ = results.data();
+            count_   = count;
+            run_     = std::max<std::size_t>(1, count / (workers_.size() * 8));
+            next_.store(0);
+            busy_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        return results;
+    }
+
+private:
+    void run() {
+        reusable_parser parser(options_);
+        std::size_t seen = 0;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_)
+                return;
+            seen = generation_;
+
+            lock.unlock();
+            work(parser);
+            lock.lock();
+
+            if (--busy_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    void work(reusable_parser &parser) {
+        while (true) {
+            const std::size_t begin = next_.fetch_add(run_);
+            if (begin >= count_)
+                return;
+            const std::size_t end = std::min(begin + run_, count_);
+            for (std::size_t i = begin; i < end; ++i) {
+                try {
+                    results_[i].parsed = parser.parse(inputs_[i]);
+                } catch (...) {
+                    results_[i].failure = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    const parse_options options_;
+    std::vector<std::thread> workers_;
+
+    std::mutex batch_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stopping_          = false;
+    std::size_t generation_ = 0;
+    std::size_t busy_       = 0;
+
+    // The batch in progress.
+    const std::string *inputs_ = nullptr;
+    batch_result *results_     = nullptr;
+    std::size_t count_         = 0;
+    std::size_t run_           = 1;
+    std::atomic<std::size_t> next_{ 0 };
+};
+
+} // namespace batch_detail
+
+batch_parser::batch_parser(std::size_t threads, const parse_options &options)
+    : pool_(std::make_unique<batch_detail::pool>(threads, options)) {
+}
+
+batch_parser::~batch_parser() = default;
+
+std::size_t batch_parser::threads() const {
+    return pool_->size();
+}
+
+std::vector<batch_result> batch_parser::parse(const std::string *inputs, std::size_t count) {
+    return pool_->parse(inputs, count);
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,545 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/filter.hpp>
+#include <mapbox/geojson/visitor.hpp>
+#include <mapbox/geojson_visitor_impl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Simplifies runs of positions in place. Scratch storage is kept between calls, so simplifying
+// the lines of a whole document does not allocate once it has grown to the longest run.
+class simplifier {
+public:
+    explicit simplifier(const parse_options &options) : options_(options) {
+    }
+
+    // The first and last positions are always kept.
+    void simplify(std::vector<point> &points) {
+        if (options_.tolerance <= 0 || points.size() <= 2)
+            return;
+
+        keep_.assign(points.size(), 0);
+        if (options_.algorithm == parse_options::simplification::visvalingam) {
+            markVisvalingam(points);
+        } else {
+            markDouglasPeucker(points);
+        }
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            if (keep_[i])
+                points[kept++] = points[i];
+        }
+        points.resize(kept);
+    }
+
+private:
+    // Squared distance from p to the segment a-b.
+    static double segmentDistanceSquared(const point &p, const point &a, const point &b) {
+        double x  = a.x;
+        double y  = a.y;
+        double dx = b.x - x;
+        double dy = b.y - y;
+        if (dx != 0 || dy != 0) {
+            const double t = ((p.x - x) * dx + (p.y - y) * dy) / (dx * dx + dy * dy);
+            if (t > 1) {
+                x = b.x;
+                y = b.y;
+            } else if (t > 0) {
+                x += dx * t;
+                y += dy * t;
+            }
+        }
+        dx = p.x - x;
+        dy = p.y - y;
+        return dx * dx + dy * dy;
+    }
+
+    static double triangleArea(const point &a, const point &b, const point &c) {
+        return std::abs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) / 2;
+    }
+
+    void markDouglasPeucker(const std::vector<point> &points) {
+        const double threshold = options_.tolerance * options_.tolerance;
+        keep_.front() = keep_.back() = 1;
+
+        ranges_.clear();
+        ranges_.emplace_back(0, points.size() - 1);
+        while (!ranges_.empty()) {
+            const auto range = ranges_.back();
+            ranges_.pop_back();
+
+            double farthest   = threshold;
+            std::size_t index = 0;
+            for (std::size_t i = range.first + 1; i < range.second; ++i) {
+                const double distance =
+                    segmentDistanceSquared(points[i], points[range.first], points[range.second]);
+                if (distance > farthest) {
+                    farthest = distance;
+                    index    = i;
+                }
+            }
+            if (index) {
+                keep_[index] = 1;
+                ranges_.emplace_back(range.first, index);
+                ranges_.emplace_back(index, range.second);
+            }
+        }
+    }
+
+    void markVisvalingam(const std::vector<point> &points) {
+        const std::size_t size = points.size();
+        const double threshold = options_.tolerance * options_.tolerance;
+
+        prev_.resize(size);
+        next_.resize(size);
+        areas_.resize(size);
+        heap_.clear();
+        for (std::size_t i = 0; i < size; ++i) {
+            keep_[i] = 1;
+            prev_[i] = i - 1;
+            next_[i] = i + 1;
+        }
+        for (std::size_t i = 1; i + 1 < size; ++i) {
+            areas_[i] = triangleArea(points[i - 1], points[i], points[i + 1]);
+            heap_.emplace_back(areas_[i], i);
+        }
+        std::make_heap(heap_.begin(), heap_.end(), std::greater<>());
+
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+            const auto smallest = heap_.back();
+            heap_.pop_back();
+
+            const std::size_t i = smallest.second;
+            // Entries are not removed when a vertex's area changes; skip the outdated ones.
+            if (!keep_[i] || smallest.first != areas_[i])
+                continue;
+            if (smallest.first >= threshold)
+                break;
+
+            keep_[i]            = 0;
+            const std::size_t p = prev_[i];
+            const std::size_t n = next_[i];
+            next_[p]            = n;
+            prev_[n]            = p;
+            if (p > 0)
+                updateArea(points, p, smallest.first);
+            if (n + 1 < size)
+                updateArea(points, n, smallest.first);
+        }
+    }
+
+    // A neighbour's area never drops below that of the vertex just removed, so vertices are
+    // removed in order of significance.
+    void updateArea(const std::vector<point> &points, std::size_t i, double minimum) {
+        areas_[i] = std::max(triangleArea(points[prev_[i]], points[i], points[next_[i]]), minimum);
+        heap_.emplace_back(areas_[i], i);
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+    }
+
+    const parse_options &options_;
+    std::vector<char> keep_;
+    std::vector<std::pair<std::size_t, std::size_t>> ranges_;
+    std::vector<std::size_t> prev_;
+    std::vector<std::size_t> next_;
+    std::vector<double> areas_;
+    std::vector<std::pair<double, std::size_t>> heap_;
+};
+
+// Builds geometries, features and feature collections from visitor events. Positions of each
+// line and ring are collected in one reused buffer and reduced there, so only the reduced
+// geometry is allocated.
+//
+// The filter applies to the features of FeatureCollections. With filterFeatures set, it applies
+// to a Feature document too, for callers that parse the features of a collection one at a time;
+// rejected() then tells whether the document was rejected, and its result is to be ignored.
+class geojson_builder : public visitor {
+public:
+    explicit geojson_builder(const parse_options &options, bool filterFeatures = false)
+        : options_(options), simplifier_(options_), filterFeatures_(filterFeatures) {
+    }
+
+    geojson result() {
+        return std::move(result_);
+    }
+
+    bool rejected() const {
+        return documentRejected_;
+    }
+
+    // Prepares for another document, keeping the capacity of the scratch buffers.
+    void reset() {
+        result_ = geojson{};
+        collection_.clear();
+        feature_ = feature{};
+        geometries_.clear();
+        points_.clear();
+        deferred_.clear();
+        inCollection_     = false;
+        inFeature_        = false;
+        dropRings_        = false;
+        dropped_          = false;
+        decided_          = true;
+        rejected_         = false;
+        documentRejected_ = false;
+    }
+
+    void begin_feature_collection() override {
+        inCollection_ = true;
+    }
+    void end_feature_collection() override {
+        result_ = std::move(collection_);
+    }
+
+    void begin_feature() override {
+        feature_        = feature{};
+        inFeature_      = true;
+        decided_        = !options_.filter || (!inCollection_ && !filterFeatures_);
+        rejected_       = false;
+        propertiesDone_ = false;
+        hasType_        = false;
+    }
+    void end_feature() override {
+        if (!decided_)
+            decide();
+        inFeature_ = false;
+        if (rejected_) {
+            rejected_ = false;
+            if (!inCollection_)
+                documentRejected_ = true;
+        } else if (inCollection_) {
+            collection_.push_back(std::move(feature_));
+        } else {
+            result_ = std::move(feature_);
+        }
+    }
+    void feature_id(identifier id) override {
+        feature_.id = std::move(id);
+    }
+    void property(std::string key, value v) override {
+        feature_.properties.emplace(std::move(key), std::move(v));
+    }
+    void end_properties() override {
+        propertiesDone_ = true;
+        if (!decided_ && (hasType_ || !options_.filter->uses_geometry_type()))
+            decide();
+    }
+
+    void begin_geometry(geometry_type type) override {
+        if (!decided_ && !hasType_) {
+            hasType_     = true;
+            featureType_ = type;
+            if (propertiesDone_)
+                decide();
+        }
+        if (held(deferred_event::kind::BeginGeometry, type))
+            return;
+        points_.clear();
+        dropRings_ = false;
+        dropped_   = false;
+        switch (type) {
+        case geometry_type::Point:
+            geometries_.emplace_back(point{});
+            break;
+        case geometry_type::LineString:
+            geometries_.emplace_back(line_string{});
+            break;
+        case geometry_type::Polygon:
+            geometries_.emplace_back(polygon{});
+            break;
+        case geometry_type::MultiPoint:
+            geometries_.emplace_back(multi_point{});
+            break;
+        case geometry_type::MultiLineString:
+            geometries_.emplace_back(multi_line_string{});
+            break;
+        case geometry_type::MultiPolygon:
+            geometries_.emplace_back(multi_polygon{});
+            break;
+        case geometry_type::GeometryCollection:
+            geometries_.emplace_back(geometry_collection{});
+            break;
+        }
+    }
+    void end_geometry(geometry_type type) override {
+        if (held(deferred_event::kind::EndGeometry, type))
+            return;
+        geometry result = std::move(geometries_.back());
+        geometries_.pop_back();
+
+        if (type == geometry_type::Point) {
+            project(false);
+            result.get<point>() = points_.front();
+        } else if (type == geometry_type::MultiPoint) {
+            project(false);
+            result.get<multi_point>().assign(points_.begin(), points_.end());
+        } else if (dropped_ && collapsed(result)) {
+            // Nothing valid is left of the geometry: it is left out of a GeometryCollection, and
+            // null elsewhere.
+            dropped_ = false;
+            if (!geometries_.empty())
+                return;
+            result = empty{};
+        }
+
+        if (!geometries_.empty()) {
+            geometries_.back().get<geometry_collection>().push_back(std::move(result));
+        } else if (inFeature_) {
+            feature_.geometry = std::move(result);
+        } else {
+            result_ = std::move(result);
+        }
+    }
+
+    void begin_polygon() override {
+        if (held(deferred_event::kind::BeginPolygon))
+            return;
+        geometries_.back().get<multi_polygon>().emplace_back();
+        dropRings_ = false;
+    }
+    void end_polygon() override {
+        if (held(deferred_event::kind::EndPolygon))
+            return;
+        auto &polygons = geometries_.back().get<multi_polygon>();
+        if (polygons.back().empty())
+            polygons.pop_back();
+    }
+
+    void begin_line_string() override {
+        if (held(deferred_event::kind::BeginLineString))
+            return;
+        points_.clear();
+    }
+    void end_line_string() override {
+        if (held(deferred_event::kind::EndLineString))
+            return;
+        if (!reduce(2)) {
+            dropped_ = true;
+            return;
+        }
+        auto &current = geometries_.back();
+        if (current.is<line_string>()) {
+            current.get<line_string>().assign(points_.begin(), points_.end());
+        } else {
+            current.get<multi_line_string>().emplace_back(points_.begin(), points_.end());
+        }
+    }
+
+    void begin_ring() override {
+        if (held(deferred_event::kind::BeginRing))
+            return;
+        points_.clear();
+    }
+    void end_ring() override {
+        if (held(deferred_event::kind::EndRing))
+            return;
+        auto &current = geometries_.back();
+        auto &rings   = current.is<polygon>() ? current.get<polygon>()
+                                              : current.get<multi_polygon>().back();
+        if (!reduce(4)) {
+            if (rings.empty())
+                dropRings_ = true;
+            dropped_ = true;
+            return;
+        }
+        if (!dropRings_)
+            rings.emplace_back(points_.begin(), points_.end());
+    }
+
+    void position(double x, double y) override {
+        if (held(deferred_event::kind::Position, geometry_type::Point, x, y))
+            return;
+        points_.emplace_back(x, y);
+    }
+
+private:
+    // A geometry event of a feature the filter has not decided on yet.
+    struct deferred_event {
+        enum class kind {
+            BeginGeometry,
+            EndGeometry,
+            BeginPolygon,
+            EndPolygon,
+            BeginLineString,
+            EndLineString,
+            BeginRing,
+            EndRing,
+            Position
+        } type;
+        geometry_type geometry;
+        double x;
+        double y;
+    };
+
+    // Whether a geometry event is kept from the geometry being built: events of features the
+    // filter rejected are dropped, and events of features it has not decided on are recorded.
+    bool held(deferred_event::kind event,
+              geometry_type type = geometry_type::Point,
+              double x           = 0,
+              double y           = 0) {
+        if (decided_ && !rejected_)
+            return false;
+        if (!decided_)
+            deferred_.push_back({ event, type, x, y });
+        return true;
+    }
+
+    // Features are filtered once their properties and geometry type are known, which is before
+    // the geometry is built when the properties come first. Otherwise the geometry's events are
+    // recorded until then, and replayed if the feature is kept.
+    void decide() {
+        decided_  = true;
+        rejected_ =
+            !options_.filter->evaluate(feature_.properties, hasType_ ? &featureType_ : nullptr);
+        if (!rejected_) {
+            for (std::size_t i = 0; i < deferred_.size(); ++i) {
+                const auto event = deferred_[i];
+                switch (event.type) {
+                case deferred_event::kind::BeginGeometry:
+                    begin_geometry(event.geometry);
+                    break;
+                case deferred_event::kind::EndGeometry:
+                    end_geometry(event.geometry);
+                    break;
+                case deferred_event::kind::BeginPolygon:
+                    begin_polygon();
+                    break;
+                case deferred_event::kind::EndPolygon:
+                    end_polygon();
+                    break;
+                case deferred_event::kind::BeginLineString:
+                    begin_line_string();
+                    break;
+                case deferred_event::kind::EndLineString:
+                    end_line_string();
+                    break;
+                case deferred_event::kind::BeginRing:
+                    begin_ring();
+                    break;
+                case deferred_event::kind::EndRing:
+                    end_ring();
+                    break;
+                case deferred_event::kind::Position:
+                    position(event.x, event.y);
+                    break;
+                }
+            }
+        }
+        deferred_.clear();
+    }
+
+    // Transforms the collected run and snaps it to the grid. Consecutive positions that snap
+    // together are merged when merge is set.
+    void project(bool merge) {
+        if (options_.transform) {
+            options_.transform(points_.data(), points_.size());
+        }
+        if (options_.grid <= 0)
+            return;
+
+        std::size_t kept = 0;
+        for (const auto &p : points_) {
+            const point snapped{ std::round(p.x / options_.grid) * options_.grid,
+                                 std::round(p.y / options_.grid) * options_.grid };
+            if (merge && kept > 0 && points_[kept - 1] == snapped)
+                continue;
+            points_[kept++] = snapped;
+        }
+        points_.resize(kept);
+    }
+
+    // Whether a line or polygon geometry has no lines or rings left.
+    static bool collapsed(const geometry &result) {
+        if (result.is<line_string>())
+            return result.get<line_string>().empty();
+        if (result.is<polygon>())
+            return result.get<polygon>().empty();
+        if (result.is<multi_line_string>())
+            return result.get<multi_line_string>().empty();
+        if (result.is<multi_polygon>())
+            return result.get<multi_polygon>().empty();
+        return false;
+    }
+
+    // Reduces the collected run and reports whether it should be kept: runs are dropped when the
+    // reductions leave fewer than minimum positions.
+    bool reduce(std::size_t minimum) {
+        const std::size_t size = points_.size();
+        project(true);
+        simplifier_.simplify(points_);
+        return points_.size() >= minimum || points_.size() == size;
+    }
+
+    const parse_options options_;
+    simplifier simplifier_;
+    const bool filterFeatures_;
+
+    geojson result_;
+    feature_collection collection_;
+    feature feature_;
+    std::vector<geometry> geometries_;
+    std::vector<point> points_;
+    bool inCollection_ = false;
+    bool inFeature_    = false;
+    bool dropRings_    = false;
+    // Whether a line or ring of the current geometry was dropped.
+    bool dropped_ = false;
+
+    // Filtering of the current feature.
+    std::vector<deferred_event> deferred_;
+    geometry_type featureType_ = geometry_type::Point;
+    bool decided_              = true;
+    bool rejected_             = false;
+    bool propertiesDone_       = false;
+    bool hasType_              = false;
+    bool documentRejected_     = false;
+};
+
+// Parses one document after another, keeping the capacity of the builder's scratch buffers and
+// of the reader's stack between them. With filterFeatures set, Feature documents are filtered
+// too, and rejected() tells whether the last one was rejected.
+class reusable_parser {
+public:
+    explicit reusable_parser(const parse_options &options, bool filterFeatures = false)
+        : options_(options), builder_(options, filterFeatures) {
+    }
+
+    bool rejected() const {
+        return builder_.rejected();
+    }
+
+    geojson parse(const std::string &json) {
+        builder_.reset();
+        parseEvents(reader_, json, builder_, options_);
+        return builder_.result();
+    }
+
+    geojson parse(const char *json, std::size_t size) {
+        builder_.reset();
+        parseEvents(reader_, json, size, builder_, options_);
+        return builder_.result();
+    }
+
+private:
+    const parse_options &options_;
+    geojson_builder builder_;
+    rapidjson::Reader reader_;
+};
+
+geojson parse(const std::string &json, const parse_options &options) {
+    geojson_builder builder(options);
+    parseEvents(json, builder, options);
+    return builder.result();
+}
+
+} // namespace geojson
+} // namespace mapbox
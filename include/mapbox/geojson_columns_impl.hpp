@@ -0,0 +1,301 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/columns.hpp>
+#include <mapbox/geojson_memory_impl.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace mapbox {
+namespace geojson {
+namespace column_detail {
+
+// Largest magnitude up to which every integer converts to a double exactly.
+constexpr std::uint64_t exact_integer = std::uint64_t(1) << 53;
+
+enum kind : unsigned {
+    BoolKind   = 1,
+    UintKind   = 2,
+    IntKind    = 4,
+    DoubleKind = 8,
+    StringKind = 16,
+    NestedKind = 32,
+};
+
+// What has been seen of one property's values.
+struct column_stats {
+    std::size_t index  = 0;
+    unsigned kinds     = 0;
+    bool uintsFitInt   = true;
+    bool integersExact = true;
+
+    void add(const value &v) {
+        if (v.is<bool>()) {
+            kinds |= BoolKind;
+        } else if (v.is<std::uint64_t>()) {
+            const auto number = v.get<std::uint64_t>();
+            kinds |= UintKind;
+            uintsFitInt   = uintsFitInt && number <= std::uint64_t(std::numeric_limits<std::int64_t>::max());
+            integersExact = integersExact && number <= exact_integer;
+        } else if (v.is<std::int64_t>()) {
+            const auto number = v.get<std::int64_t>();
+            kinds |= IntKind;
+            integersExact = integersExact && number >= -std::int64_t(exact_integer) &&
+                            number <= std::int64_t(exact_integer);
+        } else if (v.is<double>()) {
+            kinds |= DoubleKind;
+        } else if (v.is<std::string>()) {
+            kinds |= StringKind;
+        } else if (!v.is<null_value_t>()) {
+            kinds |= NestedKind;
+        }
+    }
+
+    // Whether values of other types are converted to the column's, so their types must be kept
+    // to give them back unchanged.
+    bool converts() const {
+        const column_type converted = type();
+        return (converted == column_type::Int && (kinds & UintKind)) ||
+               (converted == column_type::Double && (kinds & (UintKind | IntKind)));
+    }
+
+    column_type type() const {
+        switch (kinds) {
+        case 0:
+            return column_type::Null;
+        case BoolKind:
+            return column_type::Bool;
+        case StringKind:
+            return column_type::String;
+        case UintKind:
+            return column_type::Uint;
+        case IntKind:
+            return column_type::Int;
+        case UintKind | IntKind:
+            return uintsFitInt ? column_type::Int : column_type::Mixed;
+        case DoubleKind:
+            return column_type::Double;
+        case UintKind | DoubleKind:
+        case IntKind | DoubleKind:
+        case UintKind | IntKind | DoubleKind:
+            return integersExact ? column_type::Double : column_type::Mixed;
+        default:
+            return column_type::Mixed;
+        }
+    }
+};
+
+inline std::int64_t toInt(const value &v) {
+    return v.is<std::uint64_t>() ? std::int64_t(v.get<std::uint64_t>()) : v.get<std::int64_t>();
+}
+
+inline double toDouble(const value &v) {
+    if (v.is<std::uint64_t>())
+        return double(v.get<std::uint64_t>());
+    if (v.is<std::int64_t>())
+        return double(v.get<std::int64_t>());
+    return v.get<double>();
+}
+
+// Values of a const collection are copied, and values of a mutable one moved.
+inline const value &source(const value &v) {
+    return v;
+}
+inline value &&source(value &v) {
+    return std::move(v);
+}
+
+inline const std::string &sourceString(const value &v) {
+    return v.get<std::string>();
+}
+inline std::string &&sourceString(value &v) {
+    return std::move(v.get<std::string>());
+}
+
+} // namespace column_detail
+
+value property_column::get(std::size_t index) const {
+    if (cells_[index] != cell::Set)
+        return null_value_t{};
+    const auto original = kinds_.empty() ? value_kind::Column : value_kind(kinds_[index]);
+    switch (type_) {
+    case column_type::Bool:
+        return bool(bools_[index]);
+    case column_type::Uint:
+        return uints_[index];
+    case column_type::Int:
+        if (original == value_kind::Uint)
+            return std::uint64_t(ints_[index]);
+        return ints_[index];
+    case column_type::Double:
+        if (original == value_kind::Uint)
+            return std::uint64_t(doubles_[index]);
+        if (original == value_kind::Int)
+            return std::int64_t(doubles_[index]);
+        return doubles_[index];
+    case column_type::String:
+        return strings_[index];
+    case column_type::Mixed:
+        return values_[index];
+    case column_type::Null:
+        break;
+    }
+    return null_value_t{};
+}
+
+// The schema is inferred in a first pass over the properties, then the columns are allocated
+// and filled in a second.
+template <class Collection>
+void property_table::build(Collection &collection) {
+    using namespace column_detail;
+
+    std::unordered_map<std::string, column_stats> stats;
+    for (const auto &element : collection) {
+        for (const auto &member : element.properties) {
+            stats[member.first].add(member.second);
+        }
+    }
+
+    std::vector<const std::string *> names;
+    names.reserve(stats.size());
+    for (const auto &entry : stats) {
+        names.push_back(&entry.first);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string *a, const std::string *b) { return *a < *b; });
+
+    size_ = collection.size();
+    columns_.resize(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        auto &entry  = stats[*names[i]];
+        auto &column = columns_[i];
+        entry.index  = i;
+        column.name_ = *names[i];
+        column.type_ = entry.type();
+        column.cells_.assign(size_, property_column::cell::Missing);
+        if (entry.converts())
+            column.kinds_.assign(size_, std::uint8_t(property_column::value_kind::Column));
+        switch (column.type_) {
+        case column_type::Bool:
+            column.bools_.resize(size_);
+            break;
+        case column_type::Uint:
+            column.uints_.resize(size_);
+            break;
+        case column_type::Int:
+            column.ints_.resize(size_);
+            break;
+        case column_type::Double:
+            column.doubles_.resize(size_);
+            break;
+        case column_type::String:
+            column.strings_.resize(size_);
+            break;
+        case column_type::Mixed:
+            column.values_.resize(size_);
+            break;
+        case column_type::Null:
+            break;
+        }
+    }
+
+    for (std::size_t i = 0; i < size_; ++i) {
+        for (auto &member : collection[i].properties) {
+            auto &column = columns_[stats.find(member.first)->second.index];
+            auto &v      = member.second;
+            if (v.template is<null_value_t>()) {
+                column.cells_[i] = property_column::cell::Null;
+                continue;
+            }
+            column.cells_[i] = property_column::cell::Set;
+            switch (column.type_) {
+            case column_type::Bool:
+                column.bools_[i] = v.template get<bool>();
+                break;
+            case column_type::Uint:
+                column.uints_[i] = v.template get<std::uint64_t>();
+                break;
+            case column_type::Int:
+                column.ints_[i] = toInt(v);
+                if (v.template is<std::uint64_t>())
+                    column.kinds_[i] = std::uint8_t(property_column::value_kind::Uint);
+                break;
+            case column_type::Double:
+                column.doubles_[i] = toDouble(v);
+                if (v.template is<std::uint64_t>())
+                    column.kinds_[i] = std::uint8_t(property_column::value_kind::Uint);
+                else if (v.template is<std::int64_t>())
+                    column.kinds_[i] = std::uint8_t(property_column::value_kind::Int);
+                break;
+            case column_type::String:
+                column.strings_[i] = sourceString(v);
+                break;
+            case column_type::Mixed:
+                column.values_[i] = source(v);
+                break;
+            case column_type::Null:
+                break;
+            }
+        }
+    }
+}
+
+property_table::property_table(const feature_collection &collection) {
+    build(collection);
+}
+
+const property_column *property_table::find(const std::string &name) const {
+    const auto found = std::lower_bound(columns_.begin(), columns_.end(), name,
+                                        [](const property_column &column, const std::string &key) {
+                                            return column.name() < key;
+                                        });
+    if (found == columns_.end() || found->name() != name)
+        return nullptr;
+    return &*found;
+}
+
+value property_table::get(std::size_t index, const std::string &name) const {
+    const property_column *column = find(name);
+    return column ? column->get(index) : value{};
+}
+
+value::object_type property_table::properties(std::size_t index) const {
+    value::object_type result;
+    for (const auto &column : columns_) {
+        if (column.contains(index))
+            result.emplace(column.name(), column.get(index));
+    }
+    return result;
+}
+
+std::size_t property_table::memory_usage() const {
+    std::size_t total = columns_.capacity() * sizeof(property_column);
+    for (const auto &column : columns_) {
+        total += stringUsage(column.name_) + column.cells_.capacity() * sizeof(property_column::cell) +
+                 column.kinds_.capacity() + column.bools_.capacity() + column.uints_.capacity() * sizeof(std::uint64_t) +
+                 column.ints_.capacity() * sizeof(std::int64_t) + column.doubles_.capacity() * sizeof(double) +
+                 column.strings_.capacity() * sizeof(std::string) + column.values_.capacity() * sizeof(value);
+        for (const auto &string : column.strings_) {
+            total += stringUsage(string);
+        }
+        for (const auto &v : column.values_) {
+            total += mapbox::geojson::memory_usage(v);
+        }
+    }
+    return total;
+}
+
+property_table take_properties(feature_collection &collection) {
+    property_table result;
+    result.build(collection);
+    for (auto &element : collection) {
+        value::object_type().swap(element.properties);
+    }
+    return result;
+}
+
+} // namespace geojson
+} // namespace mapbox
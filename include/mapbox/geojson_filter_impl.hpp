@@ -0,0 +1,585 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/filter.hpp>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+namespace filter_detail {
+
+enum class relation { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+struct operand {
+    enum class kind { Literal, Property, GeometryType } source = kind::Literal;
+    std::string name;
+    value literal;
+};
+
+// The program is in postfix order: comparisons push their result and the boolean operators
+// combine the results on top of the stack.
+struct instruction {
+    enum class code { Compare, In, NotIn, And, Or, Not } op = code::Compare;
+    relation test = relation::Equal;
+    operand left;
+    operand right;
+    std::vector<value> list;
+};
+
+// The stack of results is kept in the bits of one word.
+constexpr std::size_t max_stack = 64;
+
+struct program {
+    std::vector<instruction> instructions;
+    bool geometryType = false;
+};
+
+const value &nullValue() {
+    static const value result;
+    return result;
+}
+
+const value &typeValue(geometry_type type) {
+    static const value names[] = { toString(geometry_type::Point),
+                                   toString(geometry_type::LineString),
+                                   toString(geometry_type::Polygon),
+                                   toString(geometry_type::MultiPoint),
+                                   toString(geometry_type::MultiLineString),
+                                   toString(geometry_type::MultiPolygon),
+                                   toString(geometry_type::GeometryCollection) };
+    return names[static_cast<int>(type)];
+}
+
+// Orders two numbers of any type without losing precision: -1, 0 or 1, or 2 when unordered.
+int compareNumbers(const value &a, const value &b) {
+    const auto order = [](auto x, auto y) { return x < y ? -1 : y < x ? 1 : x == y ? 0 : 2; };
+    if (a.is<std::uint64_t>() && b.is<std::uint64_t>())
+        return order(a.get<std::uint64_t>(), b.get<std::uint64_t>());
+    if (a.is<std::int64_t>() && b.is<std::int64_t>())
+        return order(a.get<std::int64_t>(), b.get<std::int64_t>());
+    // Signed integers are negative, so they are less than any unsigned one.
+    if (a.is<std::int64_t>() && b.is<std::uint64_t>())
+        return -1;
+    if (a.is<std::uint64_t>() && b.is<std::int64_t>())
+        return 1;
+
+    const auto toDouble = [](const value &v) {
+        if (v.is<std::uint64_t>())
+            return double(v.get<std::uint64_t>());
+        if (v.is<std::int64_t>())
+            return double(v.get<std::int64_t>());
+        return v.get<double>();
+    };
+    return order(toDouble(a), toDouble(b));
+}
+
+bool isNumber(const value &v) {
+    return v.is<std::uint64_t>() || v.is<std::int64_t>() || v.is<double>();
+}
+
+bool compare(const value &a, const value &b, relation test) {
+    int order = 2;
+    if (isNumber(a) && isNumber(b)) {
+        order = compareNumbers(a, b);
+    } else if (a.is<std::string>() && b.is<std::string>()) {
+        const int compared = a.get<std::string>().compare(b.get<std::string>());
+        order              = compared < 0 ? -1 : compared > 0 ? 1 : 0;
+    } else if (a.is<bool>() && b.is<bool>()) {
+        // Booleans are equal or not, but unordered.
+        if (test == relation::Equal || test == relation::NotEqual)
+            order = a.get<bool>() == b.get<bool>() ? 0 : 2;
+    } else if (a.is<null_value_t>() && b.is<null_value_t>()) {
+        order = 0;
+    } else if (test == relation::Equal || test == relation::NotEqual) {
+        order = a == b ? 0 : 2;
+    }
+
+    switch (test) {
+    case relation::Equal:
+        return order == 0;
+    case relation::NotEqual:
+        return order != 0;
+    case relation::Less:
+        return order == -1;
+    case relation::LessEqual:
+        return order == -1 || order == 0;
+    case relation::Greater:
+        return order == 1;
+    case relation::GreaterEqual:
+        return order == 1 || order == 0;
+    }
+    return false;
+}
+
+struct token {
+    enum class kind {
+        End,
+        Word,
+        Number,
+        String,
+        Type,
+        Compare,
+        And,
+        Or,
+        Not,
+        In,
+        Open,
+        Close,
+        Comma
+    } type = kind::End;
+    std::string text;
+    relation test = relation::Equal;
+    std::size_t offset = 0;
+};
+
+class lexer {
+public:
+    explicit lexer(const std::string &source) : source_(source) {
+    }
+
+    token next() {
+        while (position_ < source_.size() &&
+               std::isspace(static_cast<unsigned char>(source_[position_]))) {
+            ++position_;
+        }
+
+        token result;
+        result.offset = position_;
+        if (position_ == source_.size())
+            return result;
+
+        const char c = source_[position_];
+        const auto two = [&](char second) {
+            return position_ + 1 < source_.size() && source_[position_ + 1] == second;
+        };
+        const auto symbol = [&](token::kind type,
+                                std::size_t length,
+                                relation test = relation::Equal) {
+            result.type = type;
+            result.test = test;
+            position_ += length;
+            return result;
+        };
+
+        switch (c) {
+        case '(':
+            return symbol(token::kind::Open, 1);
+        case ')':
+            return symbol(token::kind::Close, 1);
+        case ',':
+            return symbol(token::kind::Comma, 1);
+        case '=':
+            return symbol(token::kind::Compare, two('=') ? 2 : 1, relation::Equal);
+        case '!':
+            return two('=') ? symbol(token::kind::Compare, 2, relation::NotEqual)
+                            : symbol(token::kind::Not, 1);
+        case '<':
+            return two('=') ? symbol(token::kind::Compare, 2, relation::LessEqual)
+                            : symbol(token::kind::Compare, 1, relation::Less);
+        case '>':
+            return two('=') ? symbol(token::kind::Compare, 2, relation::GreaterEqual)
+                            : symbol(token::kind::Compare, 1, relation::Greater);
+        case '&':
+            if (two('&'))
+                return symbol(token::kind::And, 2);
+            break;
+        case '|':
+            if (two('|'))
+                return symbol(token::kind::Or, 2);
+            break;
+        case '\'':
+        case '"':
+            return quoted(result, c);
+        default:
+            break;
+        }
+
+        if (c == '-' || c == '.' || isDigit(c)) {
+            result.type = token::kind::Number;
+            result.text = number();
+            return result;
+        }
+
+        if (c == '$' || isWordCharacter(c)) {
+            const std::size_t start = position_++;
+            while (position_ < source_.size() && isWordCharacter(source_[position_])) {
+                ++position_;
+            }
+            result.text = source_.substr(start, position_ - start);
+            if (result.text == "$type") {
+                result.type = token::kind::Type;
+            } else if (c == '$') {
+                fail("unknown variable " + result.text, start);
+            } else if (result.text == "and") {
+                result.type = token::kind::And;
+            } else if (result.text == "or") {
+                result.type = token::kind::Or;
+            } else if (result.text == "not") {
+                result.type = token::kind::Not;
+            } else if (result.text == "in") {
+                result.type = token::kind::In;
+            } else {
+                result.type = token::kind::Word;
+            }
+            return result;
+        }
+
+        fail(std::string("unexpected character '") + c + "'", position_);
+        return result;
+    }
+
+    [[noreturn]] static void fail(const std::string &message, std::size_t offset) {
+        std::stringstream text;
+        text << "filter expression: " << message << " at offset " << offset;
+        throw error(text.str());
+    }
+
+private:
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool isWordCharacter(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':' || c == '.' ||
+               c == '-';
+    }
+
+    // Decimal numbers only: an optional minus sign, digits, and an optional fraction and
+    // exponent. Anything a number runs into, such as the x of 0x10, is an error rather than the
+    // start of the next token.
+    std::string number() {
+        const std::size_t start = position_;
+        const auto digits = [&] {
+            const std::size_t first = position_;
+            while (position_ < source_.size() && isDigit(source_[position_])) {
+                ++position_;
+            }
+            if (position_ == first)
+                fail("expected a number", start);
+        };
+
+        if (source_[position_] == '-')
+            ++position_;
+        digits();
+        if (position_ < source_.size() && source_[position_] == '.') {
+            ++position_;
+            digits();
+        }
+        if (position_ < source_.size() &&
+            (source_[position_] == 'e' || source_[position_] == 'E')) {
+            ++position_;
+            if (position_ < source_.size() &&
+                (source_[position_] == '+' || source_[position_] == '-'))
+                ++position_;
+            digits();
+        }
+        if (position_ < source_.size() && isWordCharacter(source_[position_]))
+            fail("invalid number", start);
+        return source_.substr(start, position_ - start);
+    }
+
+    // Backslashes escape the next character.
+    token quoted(token &result, char quote) {
+        const std::size_t start = position_++;
+        result.type             = token::kind::String;
+        while (position_ < source_.size() && source_[position_] != quote) {
+            if (source_[position_] == '\\' && position_ + 1 < source_.size())
+                ++position_;
+            result.text += source_[position_++];
+        }
+        if (position_ == source_.size())
+            fail("unterminated string", start);
+        ++position_;
+        return result;
+    }
+
+    const std::string &source_;
+    std::size_t position_ = 0;
+};
+
+value literalValue(const token &t) {
+    if (t.type == token::kind::Number) {
+        const char *text      = t.text.c_str();
+        const char *const end = text + t.text.size();
+        const bool negative   = *text == '-';
+        char *parsed          = nullptr;
+        // Integers that don't fit are read as doubles.
+        if (t.text.find_first_of(".eE") == std::string::npos) {
+            errno = 0;
+            if (negative) {
+                const long long number = std::strtoll(text, &parsed, 10);
+                if (errno == 0 && parsed == end)
+                    return std::int64_t(number);
+            } else {
+                const unsigned long long number = std::strtoull(text, &parsed, 10);
+                if (errno == 0 && parsed == end)
+                    return std::uint64_t(number);
+            }
+        }
+        const double number = std::strtod(text, &parsed);
+        if (parsed != end)
+            lexer::fail("invalid number " + t.text, t.offset);
+        return number;
+    }
+    if (t.type == token::kind::Word) {
+        if (t.text == "true")
+            return true;
+        if (t.text == "false")
+            return false;
+        if (t.text == "null")
+            return null_value_t{};
+    }
+    return t.text;
+}
+
+// Comparisons are read whole; and, or, not and parentheses are arranged into postfix order with
+// an operator stack, so deeply nested expressions don't deepen the call stack.
+class compiler {
+public:
+    explicit compiler(const std::string &expression) : lexer_(expression) {
+        advance();
+    }
+
+    program compile() {
+        program result;
+        std::vector<token::kind> operators;
+        bool expectOperand = true;
+
+        const auto precedence = [](token::kind op) {
+            return op == token::kind::Not ? 3 : op == token::kind::And ? 2 : 1;
+        };
+        const auto emit = [&](token::kind op) {
+            instruction added;
+            added.op = op == token::kind::Not ? instruction::code::Not
+                                              : op == token::kind::And ? instruction::code::And
+                                                                       : instruction::code::Or;
+            result.instructions.push_back(std::move(added));
+        };
+
+        while (true) {
+            if (expectOperand) {
+                if (current_.type == token::kind::Not || current_.type == token::kind::Open) {
+                    operators.push_back(current_.type);
+                    advance();
+                    continue;
+                }
+                result.instructions.push_back(comparison(result));
+                expectOperand = false;
+                continue;
+            }
+
+            if (current_.type == token::kind::And || current_.type == token::kind::Or) {
+                while (!operators.empty() && operators.back() != token::kind::Open &&
+                       precedence(operators.back()) >= precedence(current_.type)) {
+                    emit(operators.back());
+                    operators.pop_back();
+                }
+                operators.push_back(current_.type);
+                expectOperand = true;
+                advance();
+            } else if (current_.type == token::kind::Close) {
+                while (!operators.empty() && operators.back() != token::kind::Open) {
+                    emit(operators.back());
+                    operators.pop_back();
+                }
+                if (operators.empty())
+                    lexer::fail("unmatched )", current_.offset);
+                operators.pop_back();
+                advance();
+            } else if (current_.type == token::kind::End) {
+                break;
+            } else {
+                lexer::fail("expected and, or or )", current_.offset);
+            }
+        }
+
+        while (!operators.empty()) {
+            if (operators.back() == token::kind::Open)
+                lexer::fail("unmatched (", current_.offset);
+            emit(operators.back());
+            operators.pop_back();
+        }
+
+        std::size_t depth = 0;
+        for (const auto &step : result.instructions) {
+            if (step.op == instruction::code::And || step.op == instruction::code::Or) {
+                --depth;
+            } else if (step.op != instruction::code::Not && ++depth > max_stack) {
+                lexer::fail("expression is too deeply nested", 0);
+            }
+        }
+        return result;
+    }
+
+private:
+    void advance() {
+        current_ = lexer_.next();
+    }
+
+    bool isLiteral(const token &t) const {
+        return t.type == token::kind::Number || t.type == token::kind::String ||
+               (t.type == token::kind::Word &&
+                (t.text == "true" || t.text == "false" || t.text == "null"));
+    }
+
+    operand readOperand(program &result) {
+        operand read;
+        if (isLiteral(current_)) {
+            read.literal = literalValue(current_);
+        } else if (current_.type == token::kind::Word) {
+            read.source = operand::kind::Property;
+            read.name   = current_.text;
+        } else if (current_.type == token::kind::Type) {
+            read.source         = operand::kind::GeometryType;
+            result.geometryType = true;
+        } else {
+            lexer::fail("expected a property name, $type or a literal", current_.offset);
+        }
+        advance();
+        return read;
+    }
+
+    instruction comparison(program &result) {
+        instruction read;
+        read.left = readOperand(result);
+
+        if (current_.type == token::kind::Compare) {
+            read.test = current_.test;
+            advance();
+            read.right = readOperand(result);
+            return read;
+        }
+
+        read.op = instruction::code::In;
+        if (current_.type == token::kind::Not) {
+            read.op = instruction::code::NotIn;
+            advance();
+        }
+        if (current_.type != token::kind::In)
+            lexer::fail("expected a comparison", current_.offset);
+        advance();
+        if (current_.type != token::kind::Open)
+            lexer::fail("expected (", current_.offset);
+        advance();
+        while (true) {
+            if (current_.type != token::kind::Number && current_.type != token::kind::String &&
+                current_.type != token::kind::Word)
+                lexer::fail("expected a literal", current_.offset);
+            read.list.push_back(literalValue(current_));
+            advance();
+            if (current_.type == token::kind::Close)
+                break;
+            if (current_.type != token::kind::Comma)
+                lexer::fail("expected , or )", current_.offset);
+            advance();
+        }
+        advance();
+        return read;
+    }
+
+    lexer lexer_;
+    token current_;
+};
+
+const value &resolve(const operand &source,
+                     const value::object_type &properties,
+                     const geometry_type *type) {
+    switch (source.source) {
+    case operand::kind::Literal:
+        return source.literal;
+    case operand::kind::Property: {
+        const auto found = properties.find(source.name);
+        return found == properties.end() ? nullValue() : found->second;
+    }
+    case operand::kind::GeometryType:
+        return type ? typeValue(*type) : nullValue();
+    }
+    return nullValue();
+}
+
+geometry_type typeOf(const geometry &shape) {
+    return shape.match([](const point &) { return geometry_type::Point; },
+                       [](const line_string &) { return geometry_type::LineString; },
+                       [](const polygon &) { return geometry_type::Polygon; },
+                       [](const multi_point &) { return geometry_type::MultiPoint; },
+                       [](const multi_line_string &) { return geometry_type::MultiLineString; },
+                       [](const multi_polygon &) { return geometry_type::MultiPolygon; },
+                       [](const auto &) { return geometry_type::GeometryCollection; });
+}
+
+} // namespace filter_detail
+
+feature_filter::feature_filter(const std::string &expression)
+    : program_(
+          std::make_shared<filter_detail::program>(filter_detail::compiler(expression).compile())) {
+}
+
+bool feature_filter::uses_geometry_type() const {
+    return program_->geometryType;
+}
+
+bool feature_filter::evaluate(const value::object_type &properties,
+                              const geometry_type *type) const {
+    using namespace filter_detail;
+
+    std::uint64_t stack = 0;
+    const auto push = [&](bool result) { stack = (stack << 1) | (result ? 1 : 0); };
+    const auto pop  = [&] {
+        const bool result = stack & 1;
+        stack >>= 1;
+        return result;
+    };
+
+    for (const auto &step : program_->instructions) {
+        switch (step.op) {
+        case instruction::code::Compare:
+            push(compare(resolve(step.left, properties, type),
+                         resolve(step.right, properties, type), step.test));
+            break;
+        case instruction::code::In:
+        case instruction::code::NotIn: {
+            const value &tested = resolve(step.left, properties, type);
+            bool found          = false;
+            for (const auto &candidate : step.list) {
+                if (compare(tested, candidate, relation::Equal)) {
+                    found = true;
+                    break;
+                }
+            }
+            push(found == (step.op == instruction::code::In));
+            break;
+        }
+        case instruction::code::And: {
+            const bool right = pop();
+            push(pop() && right);
+            break;
+        }
+        case instruction::code::Or: {
+            const bool right = pop();
+            push(pop() || right);
+            break;
+        }
+        case instruction::code::Not:
+            push(!pop());
+            break;
+        }
+    }
+    return stack & 1;
+}
+
+bool feature_filter::operator()(const feature &element) const {
+    if (element.geometry.is<empty>())
+        return evaluate(element.properties, nullptr);
+    const geometry_type type = filter_detail::typeOf(element.geometry);
+    return evaluate(element.properties, &type);
+}
+
+} // namespace geojson
+} // namespace mapbox
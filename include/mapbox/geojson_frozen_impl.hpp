@@ -0,0 +1,744 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/frozen.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+namespace frozen_detail {
+
+// Nodes are geometries, or the runs of positions that make up their parts. Children of a node
+// are stored next to each other, as are the positions of a run.
+constexpr std::uint8_t runKind   = 7;
+constexpr std::uint8_t emptyKind = 8;
+
+struct node_record {
+    std::uint8_t kind; // a geometry_type, runKind or emptyKind
+    std::size_t first; // first child node, or first position
+    std::size_t size;
+};
+
+// Numbers and booleans keep their bits in first. Strings refer to characters, arrays to values
+// and objects to members.
+struct value_record {
+    frozen_value::kind type;
+    std::uint64_t first;
+    std::size_t size;
+};
+
+struct member_record {
+    std::size_t key;
+    std::size_t key_size;
+    std::size_t value;
+};
+
+struct feature_record {
+    std::size_t geometry_node;
+    std::size_t id_value;
+    std::size_t properties_value;
+};
+
+// Stored at the start of the block, so views stay valid when the collection is moved.
+struct sections {
+    const feature_record *features;
+    std::size_t feature_count;
+    const node_record *nodes;
+    const point *points;
+    const member_record *members;
+    const value_record *values;
+    const char *chars;
+};
+
+// Packs a collection in two passes: the first counts the records of each kind, so the block can
+// be allocated at its final size, and the second fills it.
+class packer {
+public:
+    explicit packer(const feature_collection &collection) : collection_(collection) {
+        for (const auto &element : collection) {
+            ++nodeCount_;
+            pendingGeometries_.assign(1, &element.geometry);
+            while (!pendingGeometries_.empty()) {
+                const auto *current = pendingGeometries_.back();
+                pendingGeometries_.pop_back();
+                geometry::visit(*current, [&](const auto &alternative) { measure(alternative); });
+            }
+
+            valueCount_ += 2;
+            if (element.id.is<std::string>())
+                charCount_ += element.id.get<std::string>().size();
+            measure(element.properties);
+        }
+    }
+
+    std::unique_ptr<char[]> pack(std::size_t &bytes) {
+        std::size_t offset              = sizeof(sections);
+        const std::size_t featureOffset = place<feature_record>(offset, collection_.size());
+        const std::size_t nodeOffset    = place<node_record>(offset, nodeCount_);
+        const std::size_t pointOffset   = place<point>(offset, pointCount_);
+        const std::size_t memberOffset  = place<member_record>(offset, memberCount_);
+        const std::size_t valueOffset   = place<value_record>(offset, valueCount_);
+        const std::size_t charOffset    = place<char>(offset, charCount_);
+        bytes                           = offset;
+
+        std::unique_ptr<char[]> arena(new char[bytes]);
+        char *base = arena.get();
+        features_  = reinterpret_cast<feature_record *>(base + featureOffset);
+        nodes_     = reinterpret_cast<node_record *>(base + nodeOffset);
+        points_    = reinterpret_cast<point *>(base + pointOffset);
+        members_   = reinterpret_cast<member_record *>(base + memberOffset);
+        values_    = reinterpret_cast<value_record *>(base + valueOffset);
+        chars_     = base + charOffset;
+        new (base) sections{ features_, collection_.size(), nodes_, points_, members_, values_, chars_ };
+
+        for (std::size_t i = 0; i < collection_.size(); ++i) {
+            const auto &element = collection_[i];
+            features_[i] = { reserveNodes(1), reserveValues(1), reserveValues(1) };
+
+            pendingNodes_.assign(1, { features_[i].geometry_node, &element.geometry });
+            while (!pendingNodes_.empty()) {
+                const auto next = pendingNodes_.back();
+                pendingNodes_.pop_back();
+                geometry::visit(*next.second,
+                                [&](const auto &alternative) { fill(next.first, alternative); });
+            }
+
+            fillIdentifier(features_[i].id_value, element.id);
+            fill(features_[i].properties_value, element.properties);
+            drainValues();
+        }
+        return arena;
+    }
+
+private:
+    template <class T>
+    static std::size_t place(std::size_t &offset, std::size_t count) {
+        const std::size_t start = (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+        offset                  = start + count * sizeof(T);
+        return start;
+    }
+
+    void measure(const empty &) {
+    }
+    void measure(const point &) {
+        ++pointCount_;
+    }
+    void measure(const std::vector<point> &run) {
+        pointCount_ += run.size();
+    }
+    template <class Part>
+    void measure(const std::vector<Part> &parts) {
+        nodeCount_ += parts.size();
+        for (const auto &part : parts) {
+            measure(part);
+        }
+    }
+    void measure(const geometry_collection &collection) {
+        nodeCount_ += collection.size();
+        for (const auto &child : collection) {
+            pendingGeometries_.push_back(&child);
+        }
+    }
+
+    void measure(const value::object_type &object) {
+        memberCount_ += object.size();
+        valueCount_ += object.size();
+        for (const auto &member : object) {
+            charCount_ += member.first.size();
+            pendingValues_.push_back(&member.second);
+        }
+        while (!pendingValues_.empty()) {
+            const value &current = *pendingValues_.back();
+            pendingValues_.pop_back();
+            if (const auto *string = current.getString()) {
+                charCount_ += string->size();
+            } else if (const auto *array = current.getArray()) {
+                valueCount_ += array->size();
+                for (const auto &item : *array) {
+                    pendingValues_.push_back(&item);
+                }
+            } else if (const auto *nested = current.getObject()) {
+                memberCount_ += nested->size();
+                valueCount_ += nested->size();
+                for (const auto &member : *nested) {
+                    charCount_ += member.first.size();
+                    pendingValues_.push_back(&member.second);
+                }
+            }
+        }
+    }
+
+    std::size_t reserveNodes(std::size_t count) {
+        nextNode_ += count;
+        return nextNode_ - count;
+    }
+    std::size_t reserveValues(std::size_t count) {
+        nextValue_ += count;
+        return nextValue_ - count;
+    }
+    std::size_t copyPoints(const std::vector<point> &run) {
+        std::copy(run.begin(), run.end(), points_ + nextPoint_);
+        nextPoint_ += run.size();
+        return nextPoint_ - run.size();
+    }
+    std::size_t copyChars(const std::string &string) {
+        std::memcpy(chars_ + nextChar_, string.data(), string.size());
+        nextChar_ += string.size();
+        return nextChar_ - string.size();
+    }
+
+    static std::uint8_t kind(geometry_type type) {
+        return std::uint8_t(type);
+    }
+
+    void fill(std::size_t slot, const empty &) {
+        nodes_[slot] = { emptyKind, 0, 0 };
+    }
+    void fill(std::size_t slot, const point &p) {
+        points_[nextPoint_] = p;
+        nodes_[slot]        = { kind(geometry_type::Point), nextPoint_++, 1 };
+    }
+    void fill(std::size_t slot, const multi_point &run) {
+        nodes_[slot] = { kind(geometry_type::MultiPoint), copyPoints(run), run.size() };
+    }
+    void fill(std::size_t slot, const line_string &run) {
+        nodes_[slot] = { kind(geometry_type::LineString), copyPoints(run), run.size() };
+    }
+    template <class Run>
+    void fillRuns(std::size_t slot, geometry_type type, const std::vector<Run> &runs) {
+        const std::size_t first = reserveNodes(runs.size());
+        nodes_[slot]            = { kind(type), first, runs.size() };
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            nodes_[first + i] = { runKind, copyPoints(runs[i]), runs[i].size() };
+        }
+    }
+    void fill(std::size_t slot, const polygon &rings) {
+        fillRuns(slot, geometry_type::Polygon, rings);
+    }
+    void fill(std::size_t slot, const multi_line_string &lines) {
+        fillRuns(slot, geometry_type::MultiLineString, lines);
+    }
+    void fill(std::size_t slot, const multi_polygon &polygons) {
+        const std::size_t first = reserveNodes(polygons.size());
+        nodes_[slot]            = { kind(geometry_type::MultiPolygon), first, polygons.size() };
+        for (std::size_t i = 0; i < polygons.size(); ++i) {
+            fill(first + i, polygons[i]);
+        }
+    }
+    void fill(std::size_t slot, const geometry_collection &collection) {
+        const std::size_t first = reserveNodes(collection.size());
+        nodes_[slot] = { kind(geometry_type::GeometryCollection), first, collection.size() };
+        for (std::size_t i = 0; i < collection.size(); ++i) {
+            pendingNodes_.emplace_back(first + i, &collection[i]);
+        }
+    }
+
+    static std::uint64_t bits(double number) {
+        std::uint64_t result;
+        std::memcpy(&result, &number, sizeof(result));
+        return result;
+    }
+
+    void fillIdentifier(std::size_t slot, const identifier &id) {
+        using kind_type = frozen_value::kind;
+        values_[slot]   = id.match(
+            [&](null_value_t) -> value_record { return { kind_type::Null, 0, 0 }; },
+            [&](std::uint64_t n) -> value_record { return { kind_type::Uint, n, 0 }; },
+            [&](std::int64_t n) -> value_record { return { kind_type::Int, std::uint64_t(n), 0 }; },
+            [&](double n) -> value_record { return { kind_type::Double, bits(n), 0 }; },
+            [&](const std::string &s) -> value_record {
+                return { kind_type::String, copyChars(s), s.size() };
+            });
+    }
+
+    // Members are sorted by key so they can be found by binary search.
+    void fill(std::size_t slot, const value::object_type &object) {
+        sorted_.clear();
+        for (const auto &member : object) {
+            sorted_.push_back(&member);
+        }
+        std::sort(sorted_.begin(), sorted_.end(),
+                  [](const auto *a, const auto *b) { return a->first < b->first; });
+
+        const std::size_t first  = nextMember_;
+        const std::size_t values = reserveValues(object.size());
+        nextMember_ += object.size();
+        values_[slot] = { frozen_value::kind::Object, first, object.size() };
+        for (std::size_t i = 0; i < sorted_.size(); ++i) {
+            members_[first + i] = { copyChars(sorted_[i]->first), sorted_[i]->first.size(), values + i };
+            pendingSlots_.emplace_back(values + i, &sorted_[i]->second);
+        }
+    }
+
+    void drainValues() {
+        using kind_type = frozen_value::kind;
+        while (!pendingSlots_.empty()) {
+            const auto next = pendingSlots_.back();
+            pendingSlots_.pop_back();
+            const std::size_t slot = next.first;
+            const value &current   = *next.second;
+
+            if (const auto *string = current.getString()) {
+                values_[slot] = { kind_type::String, copyChars(*string), string->size() };
+            } else if (const auto *array = current.getArray()) {
+                const std::size_t first = reserveValues(array->size());
+                values_[slot]           = { kind_type::Array, first, array->size() };
+                for (std::size_t i = 0; i < array->size(); ++i) {
+                    pendingSlots_.emplace_back(first + i, &(*array)[i]);
+                }
+            } else if (const auto *object = current.getObject()) {
+                fill(slot, *object);
+            } else if (current.is<bool>()) {
+                values_[slot] = { kind_type::Bool, current.get<bool>() ? 1u : 0u, 0 };
+            } else if (current.is<std::uint64_t>()) {
+                values_[slot] = { kind_type::Uint, current.get<std::uint64_t>(), 0 };
+            } else if (current.is<std::int64_t>()) {
+                values_[slot] = { kind_type::Int, std::uint64_t(current.get<std::int64_t>()), 0 };
+            } else if (current.is<double>()) {
+                values_[slot] = { kind_type::Double, bits(current.get<double>()), 0 };
+            } else {
+                values_[slot] = { kind_type::Null, 0, 0 };
+            }
+        }
+    }
+
+    const feature_collection &collection_;
+
+    std::size_t nodeCount_   = 0;
+    std::size_t pointCount_  = 0;
+    std::size_t memberCount_ = 0;
+    std::size_t valueCount_  = 0;
+    std::size_t charCount_   = 0;
+
+    std::size_t nextNode_   = 0;
+    std::size_t nextPoint_  = 0;
+    std::size_t nextMember_ = 0;
+    std::size_t nextValue_  = 0;
+    std::size_t nextChar_   = 0;
+
+    feature_record *features_ = nullptr;
+    node_record *nodes_       = nullptr;
+    point *points_            = nullptr;
+    member_record *members_   = nullptr;
+    value_record *values_     = nullptr;
+    char *chars_              = nullptr;
+
+    std::vector<const geometry *> pendingGeometries_;
+    std::vector<const value *> pendingValues_;
+    std::vector<std::pair<std::size_t, const geometry *>> pendingNodes_;
+    std::vector<std::pair<std::size_t, const value *>> pendingSlots_;
+    std::vector<const value::object_type::value_type *> sorted_;
+};
+
+} // namespace frozen_detail
+
+using frozen_detail::node_record;
+using frozen_detail::value_record;
+
+frozen_value::kind frozen_value::type() const {
+    return sections_->values[index_].type;
+}
+
+bool frozen_value::get_bool() const {
+    return sections_->values[index_].first != 0;
+}
+
+std::uint64_t frozen_value::get_uint() const {
+    return sections_->values[index_].first;
+}
+
+std::int64_t frozen_value::get_int() const {
+    return std::int64_t(sections_->values[index_].first);
+}
+
+double frozen_value::get_double() const {
+    const std::uint64_t bits = sections_->values[index_].first;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+frozen_string frozen_value::get_string() const {
+    const auto &record = sections_->values[index_];
+    return { sections_->chars + std::size_t(record.first), record.size };
+}
+
+std::size_t frozen_value::size() const {
+    const auto &record = sections_->values[index_];
+    return record.type == kind::Array || record.type == kind::Object ? record.size : 0;
+}
+
+frozen_value frozen_value::operator[](std::size_t i) const {
+    const auto &record = sections_->values[index_];
+    if (record.type == kind::Object)
+        return { sections_, sections_->members[std::size_t(record.first) + i].value };
+    return { sections_, std::size_t(record.first) + i };
+}
+
+frozen_string frozen_value::key(std::size_t i) const {
+    const auto &member = sections_->members[std::size_t(sections_->values[index_].first) + i];
+    return { sections_->chars + member.key, member.key_size };
+}
+
+std::size_t frozen_value::find(const std::string &name) const {
+    const auto &record = sections_->values[index_];
+    if (record.type != kind::Object)
+        return size();
+
+    const auto *first = sections_->members + record.first;
+    const auto *last  = first + record.size;
+    const auto *found = std::lower_bound(first, last, name, [&](const auto &member, const auto &target) {
+        return target.compare(0, target.size(), sections_->chars + member.key, member.key_size) > 0;
+    });
+    if (found == last || !(key(std::size_t(found - first)) == name))
+        return record.size;
+    return std::size_t(found - first);
+}
+
+frozen_value frozen_value::at(const std::string &name) const {
+    const std::size_t i = find(name);
+    if (i == size())
+        throw std::out_of_range("frozen_value::at: no member " + name);
+    return (*this)[i];
+}
+
+// Arrays and objects are thawed with an explicit stack, like the conversions.
+value frozen_value::thaw() const {
+    struct frame {
+        std::size_t index;
+        std::size_t next;
+        value::array_type array;
+        value::object_type object;
+    };
+
+    const auto scalar = [&](const frozen_value &v) -> value {
+        switch (v.type()) {
+        case kind::Bool:
+            return v.get_bool();
+        case kind::Uint:
+            return v.get_uint();
+        case kind::Int:
+            return v.get_int();
+        case kind::Double:
+            return v.get_double();
+        case kind::String:
+            return v.get_string().str();
+        default:
+            return null_value_t{};
+        }
+    };
+
+    if (type() != kind::Array && type() != kind::Object)
+        return scalar(*this);
+
+    std::vector<frame> stack;
+    stack.push_back({ index_, 0, {}, {} });
+    while (true) {
+        auto &top = stack.back();
+        const frozen_value current{ sections_, top.index };
+        const bool isArray = current.type() == kind::Array;
+
+        if (top.next == current.size()) {
+            value done = isArray ? value{ std::move(top.array) } : value{ std::move(top.object) };
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+
+            auto &parent = stack.back();
+            const frozen_value container{ sections_, parent.index };
+            if (container.type() == kind::Array) {
+                parent.array.push_back(std::move(done));
+            } else {
+                parent.object.emplace(container.key(parent.next - 1).str(), std::move(done));
+            }
+            continue;
+        }
+
+        const std::size_t i         = top.next++;
+        const frozen_value element  = current[i];
+        if (element.type() == kind::Array || element.type() == kind::Object) {
+            stack.push_back({ element.index_, 0, {}, {} });
+        } else if (isArray) {
+            top.array.push_back(scalar(element));
+        } else {
+            top.object.emplace(current.key(i).str(), scalar(element));
+        }
+    }
+}
+
+bool frozen_geometry::empty() const {
+    return sections_->nodes[index_].kind == frozen_detail::emptyKind;
+}
+
+geometry_type frozen_geometry::type() const {
+    return geometry_type(sections_->nodes[index_].kind);
+}
+
+point_span frozen_geometry::points() const {
+    const auto &node = sections_->nodes[index_];
+    return { sections_->points + node.first, node.size };
+}
+
+std::size_t frozen_geometry::size() const {
+    return sections_->nodes[index_].size;
+}
+
+point_span frozen_geometry::part(std::size_t i) const {
+    const auto &run = sections_->nodes[sections_->nodes[index_].first + i];
+    return { sections_->points + run.first, run.size };
+}
+
+frozen_geometry frozen_geometry::operator[](std::size_t i) const {
+    return { sections_, sections_->nodes[index_].first + i };
+}
+
+namespace {
+
+template <class Container>
+Container thawRun(const point_span &run) {
+    return Container(run.begin(), run.end());
+}
+
+template <class Container>
+Container thawRuns(const frozen_geometry &parts) {
+    Container result;
+    result.reserve(parts.size());
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        result.push_back(thawRun<typename Container::value_type>(parts.part(i)));
+    }
+    return result;
+}
+
+geometry thawSimple(const frozen_geometry &element) {
+    switch (element.type()) {
+    case geometry_type::Point:
+        return element.points()[0];
+    case geometry_type::MultiPoint:
+        return thawRun<multi_point>(element.points());
+    case geometry_type::LineString:
+        return thawRun<line_string>(element.points());
+    case geometry_type::Polygon:
+        return thawRuns<polygon>(element);
+    case geometry_type::MultiLineString:
+        return thawRuns<multi_line_string>(element);
+    case geometry_type::MultiPolygon: {
+        multi_polygon result;
+        result.reserve(element.size());
+        for (std::size_t i = 0; i < element.size(); ++i) {
+            result.push_back(thawRuns<polygon>(element[i]));
+        }
+        return result;
+    }
+    case geometry_type::GeometryCollection:
+        break;
+    }
+    return geometry{};
+}
+
+} // namespace
+
+// Nested collections are thawed with an explicit stack, like the conversions.
+mapbox::geojson::geometry frozen_geometry::thaw() const {
+    if (empty())
+        return geometry{};
+    if (type() != geometry_type::GeometryCollection)
+        return thawSimple(*this);
+
+    struct frame {
+        frozen_geometry collection;
+        std::size_t next;
+        geometry_collection result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ *this, 0, {} });
+    stack.back().result.reserve(size());
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.collection.size()) {
+            geometry_collection done = std::move(top.result);
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+            stack.back().result.emplace_back(std::move(done));
+            continue;
+        }
+
+        const frozen_geometry child = top.collection[top.next++];
+        if (child.empty()) {
+            top.result.emplace_back();
+        } else if (child.type() == geometry_type::GeometryCollection) {
+            stack.push_back({ child, 0, {} });
+            stack.back().result.reserve(child.size());
+        } else {
+            top.result.push_back(thawSimple(child));
+        }
+    }
+}
+
+frozen_geometry frozen_feature::geometry() const {
+    return { sections_, sections_->features[index_].geometry_node };
+}
+
+frozen_value frozen_feature::id() const {
+    return { sections_, sections_->features[index_].id_value };
+}
+
+frozen_value frozen_feature::properties() const {
+    return { sections_, sections_->features[index_].properties_value };
+}
+
+feature frozen_feature::thaw() const {
+    feature result{ geometry().thaw() };
+
+    const frozen_value frozenId = id();
+    switch (frozenId.type()) {
+    case frozen_value::kind::Uint:
+        result.id = frozenId.get_uint();
+        break;
+    case frozen_value::kind::Int:
+        result.id = frozenId.get_int();
+        break;
+    case frozen_value::kind::Double:
+        result.id = frozenId.get_double();
+        break;
+    case frozen_value::kind::String:
+        result.id = frozenId.get_string().str();
+        break;
+    default:
+        break;
+    }
+
+    value thawed = properties().thaw();
+    result.properties = std::move(*thawed.getObject());
+    return result;
+}
+
+frozen_feature_collection::frozen_feature_collection()
+    : frozen_feature_collection(feature_collection{}) {
+}
+
+frozen_feature_collection::frozen_feature_collection(const feature_collection &collection) {
+    frozen_detail::packer packer(collection);
+    arena_ = packer.pack(bytes_);
+}
+
+const frozen_detail::sections *frozen_feature_collection::sections() const {
+    return reinterpret_cast<const frozen_detail::sections *>(arena_.get());
+}
+
+std::size_t frozen_feature_collection::size() const {
+    return arena_ ? sections()->feature_count : 0;
+}
+
+frozen_feature frozen_feature_collection::operator[](std::size_t i) const {
+    return { sections(), i };
+}
+
+feature_collection frozen_feature_collection::thaw() const {
+    feature_collection result;
+    result.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        result.push_back((*this)[i].thaw());
+    }
+    return result;
+}
+
+frozen_feature_collection freeze(feature_collection &&collection) {
+    frozen_feature_collection result(collection);
+    feature_collection().swap(collection);
+    return result;
+}
+
+namespace {
+
+void shrinkGeometry(geometry &root) {
+    std::vector<geometry *> pending{ &root };
+    while (!pending.empty()) {
+        geometry &current = *pending.back();
+        pending.pop_back();
+        current.match(
+            [&](geometry_collection &collection) {
+                collection.shrink_to_fit();
+                for (auto &child : collection) {
+                    pending.push_back(&child);
+                }
+            },
+            [&](multi_polygon &polygons) {
+                polygons.shrink_to_fit();
+                for (auto &rings : polygons) {
+                    rings.shrink_to_fit();
+                    for (auto &ring : rings) {
+                        ring.shrink_to_fit();
+                    }
+                }
+            },
+            [&](polygon &rings) {
+                rings.shrink_to_fit();
+                for (auto &ring : rings) {
+                    ring.shrink_to_fit();
+                }
+            },
+            [&](multi_line_string &lines) {
+                lines.shrink_to_fit();
+                for (auto &line : lines) {
+                    line.shrink_to_fit();
+                }
+            },
+            [&](line_string &line) { line.shrink_to_fit(); },
+            [&](multi_point &points) { points.shrink_to_fit(); },
+            [&](point &) {}, [&](empty &) {});
+    }
+}
+
+void shrinkProperties(value::object_type &properties) {
+    std::vector<value::object_type *> objects{ &properties };
+    std::vector<value *> pending;
+    while (!objects.empty() || !pending.empty()) {
+        if (!objects.empty()) {
+            auto &object = *objects.back();
+            objects.pop_back();
+            object.rehash(0);
+            for (auto &member : object) {
+                pending.push_back(&member.second);
+            }
+            continue;
+        }
+
+        value &current = *pending.back();
+        pending.pop_back();
+        if (auto *string = current.getString()) {
+            string->shrink_to_fit();
+        } else if (auto *array = current.getArray()) {
+            array->shrink_to_fit();
+            for (auto &item : *array) {
+                pending.push_back(&item);
+            }
+        } else if (auto *object = current.getObject()) {
+            objects.push_back(object);
+        }
+    }
+}
+
+} // namespace
+
+void shrink_to_fit(feature_collection &collection) {
+    collection.shrink_to_fit();
+    for (auto &element : collection) {
+        shrinkGeometry(element.geometry);
+        shrinkProperties(element.properties);
+        if (element.id.is<std::string>()) {
+            element.id.get<std::string>().shrink_to_fit();
+        }
+    }
+}
+
+} // namespace geojson
+} // namespace mapbox
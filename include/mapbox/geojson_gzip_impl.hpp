@@ -0,0 +1,214 @@
+#pragma once
+
+#include <mapbox/geojson_builder_impl.hpp>
+#include <mapbox/geojson_writer_impl.hpp>
+#include <mapbox/geojson/gzip.hpp>
+
+#include <rapidjson/writer.h>
+
+#include <zlib.h>
+
+#include <cassert>
+#include <sstream>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+constexpr std::size_t gzip_block_size = 64 * 1024;
+
+// A rapidjson input stream over compressed data, inflating one block at a time.
+class gzip_input_stream {
+public:
+    using Ch = char;
+
+    gzip_input_stream(std::istream &input, std::size_t max_bytes)
+        : input_(input), maxBytes_(max_bytes), in_(gzip_block_size), out_(gzip_block_size) {
+        // 32 added to the window bits detects gzip and zlib headers.
+        if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+            throw error("failed to initialize zlib");
+    }
+
+    ~gzip_input_stream() {
+        inflateEnd(&stream_);
+    }
+
+    gzip_input_stream(const gzip_input_stream &) = delete;
+    gzip_input_stream &operator=(const gzip_input_stream &) = delete;
+
+    Ch Peek() {
+        if (current_ == size_)
+            fill();
+        return current_ == size_ ? '\0' : out_[current_];
+    }
+
+    Ch Take() {
+        const Ch c = Peek();
+        if (current_ != size_)
+            ++current_;
+        return c;
+    }
+
+    std::size_t Tell() const {
+        return offset_ + current_;
+    }
+
+    // Only used for in situ parsing.
+    Ch *PutBegin() {
+        assert(false);
+        return nullptr;
+    }
+    void Put(Ch) {
+        assert(false);
+    }
+    void Flush() {
+        assert(false);
+    }
+    std::size_t PutEnd(Ch *) {
+        assert(false);
+        return 0;
+    }
+
+private:
+    void fill() {
+        offset_ += size_;
+        current_ = 0;
+        size_    = 0;
+
+        while (size_ == 0) {
+            if (stream_.avail_in == 0) {
+                input_.read(in_.data(), static_cast<std::streamsize>(in_.size()));
+                stream_.next_in  = reinterpret_cast<Bytef *>(in_.data());
+                stream_.avail_in = static_cast<uInt>(input_.gcount());
+                if (stream_.avail_in == 0) {
+                    if (!ended_)
+                        throw error("compressed input is truncated");
+                    return;
+                }
+            }
+
+            // Concatenated gzip members make up a single document.
+            if (ended_) {
+                inflateReset(&stream_);
+                ended_ = false;
+            }
+
+            stream_.next_out  = reinterpret_cast<Bytef *>(out_.data());
+            stream_.avail_out = static_cast<uInt>(out_.size());
+            const int status  = inflate(&stream_, Z_NO_FLUSH);
+            if (status == Z_STREAM_END) {
+                ended_ = true;
+            } else if (status != Z_OK && status != Z_BUF_ERROR) {
+                throw error(std::string("invalid compressed input: ") +
+                            (stream_.msg ? stream_.msg : "unknown error"));
+            }
+            size_ = out_.size() - stream_.avail_out;
+        }
+
+        if (maxBytes_ && offset_ + size_ > maxBytes_) {
+            std::stringstream message;
+            message << "input exceeds the limit of " << maxBytes_ << " bytes";
+            throw limit_error(message.str());
+        }
+    }
+
+    std::istream &input_;
+    std::size_t maxBytes_;
+    z_stream stream_{};
+    bool ended_ = false;
+
+    std::vector<char> in_;
+    std::vector<char> out_;
+    std::size_t offset_  = 0;
+    std::size_t current_ = 0;
+    std::size_t size_    = 0;
+};
+
+// A rapidjson output stream that deflates one block at a time into a gzip stream.
+class gzip_output_stream {
+public:
+    using Ch = char;
+
+    gzip_output_stream(std::ostream &output, int level)
+        : output_(output), in_(gzip_block_size), out_(gzip_block_size) {
+        // 16 added to the window bits writes a gzip header.
+        if (deflateInit2(&stream_, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw error("failed to initialize zlib");
+    }
+
+    ~gzip_output_stream() {
+        deflateEnd(&stream_);
+    }
+
+    gzip_output_stream(const gzip_output_stream &) = delete;
+    gzip_output_stream &operator=(const gzip_output_stream &) = delete;
+
+    void Put(Ch c) {
+        if (size_ == in_.size())
+            deflateBlock(Z_NO_FLUSH);
+        in_[size_++] = c;
+    }
+
+    // Called by the writer after each complete document; the data is flushed by finish().
+    void Flush() {
+    }
+
+    void finish() {
+        deflateBlock(Z_FINISH);
+        output_.flush();
+        if (!output_)
+            throw error("failed to write compressed output");
+    }
+
+private:
+    void deflateBlock(int flush) {
+        stream_.next_in  = reinterpret_cast<Bytef *>(in_.data());
+        stream_.avail_in = static_cast<uInt>(size_);
+        int status;
+        do {
+            stream_.next_out  = reinterpret_cast<Bytef *>(out_.data());
+            stream_.avail_out = static_cast<uInt>(out_.size());
+            status            = deflate(&stream_, flush);
+            assert(status != Z_STREAM_ERROR);
+            output_.write(out_.data(), static_cast<std::streamsize>(out_.size() - stream_.avail_out));
+        } while (stream_.avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+        size_ = 0;
+
+        if (!output_)
+            throw error("failed to write compressed output");
+    }
+
+    std::ostream &output_;
+    z_stream stream_{};
+
+    std::vector<char> in_;
+    std::vector<char> out_;
+    std::size_t size_ = 0;
+};
+
+geojson parse_gzip(std::istream &input, const parse_options &options) {
+    geojson_builder builder(options);
+    gzip_input_stream stream(input, options.limits.max_input_bytes);
+    parseStream(stream, builder, options);
+    return builder.result();
+}
+
+void parse_gzip(std::istream &input, visitor &v) {
+    const parse_options options;
+    gzip_input_stream stream(input, options.limits.max_input_bytes);
+    parseStream(stream, v, options);
+}
+
+void stringify_gzip(const geojson &element,
+                    std::ostream &output,
+                    const stringify_options &options,
+                    int level) {
+    gzip_output_stream stream(output, level);
+    rapidjson::Writer<gzip_output_stream> writer(stream);
+    geojson_writer<rapidjson::Writer<gzip_output_stream>> out(writer, options);
+    geojson::visit(element, [&](const auto &alternative) { out.write(alternative); });
+    stream.finish();
+}
+
+} // namespace geojson
+} // namespace mapbox
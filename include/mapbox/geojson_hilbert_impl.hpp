@@ -0,0 +1,128 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/hilbert.hpp>
+#include <mapbox/geojson_parallel_impl.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+namespace hilbert_detail {
+
+constexpr std::uint32_t grid_size = 1u << 16;
+
+// Position of a cell along a Hilbert curve that fills the grid.
+inline std::uint64_t curveIndex(std::uint32_t x, std::uint32_t y) {
+    std::uint64_t index = 0;
+    for (std::uint32_t s = grid_size / 2; s > 0; s /= 2) {
+        const std::uint32_t rx = (x & s) ? 1 : 0;
+        const std::uint32_t ry = (y & s) ? 1 : 0;
+        index += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = grid_size - 1 - x;
+                y = grid_size - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+// The order of count features, whose geometries are given by geometryOf(i).
+template <class GeometryOf>
+std::vector<std::size_t> order(std::size_t count, GeometryOf geometryOf, std::size_t threads) {
+    using namespace parallel_detail;
+
+    // Each run of features is handled by one thread.
+    const auto bounds      = splitRuns(count, threads, 4096);
+    const std::size_t runs = bounds.size() - 1;
+
+    // Centers of the bounding boxes; NaN for features without positions.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<point> centers(count);
+    parallelFor(runs, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            double minX = std::numeric_limits<double>::infinity();
+            double minY = minX;
+            double maxX = -minX;
+            double maxY = -minX;
+            mapbox::geometry::for_each_point(geometryOf(i), [&](const point &p) {
+                minX = std::min(minX, p.x);
+                minY = std::min(minY, p.y);
+                maxX = std::max(maxX, p.x);
+                maxY = std::max(maxY, p.y);
+            });
+            centers[i] = minX <= maxX ? point{ (minX + maxX) / 2, (minY + maxY) / 2 } : point{ nan, nan };
+        }
+    });
+
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = minX;
+    double maxX = -minX;
+    double maxY = -minX;
+    for (const auto &center : centers) {
+        if (std::isnan(center.x))
+            continue;
+        minX = std::min(minX, center.x);
+        minY = std::min(minY, center.y);
+        maxX = std::max(maxX, center.x);
+        maxY = std::max(maxY, center.y);
+    }
+    const double scaleX = maxX > minX ? (grid_size - 1) / (maxX - minX) : 0;
+    const double scaleY = maxY > minY ? (grid_size - 1) / (maxY - minY) : 0;
+
+    // Keys are paired with indices, which keeps features with equal keys in input order. Each
+    // run is sorted on its own thread, then runs are merged pairwise.
+    const std::uint64_t last = std::uint64_t(grid_size) * grid_size;
+    std::vector<std::pair<std::uint64_t, std::size_t>> keys(count);
+    parallelFor(runs, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            const auto &center = centers[i];
+            if (std::isnan(center.x)) {
+                keys[i] = { last, i };
+            } else {
+                keys[i] = { curveIndex(std::uint32_t((center.x - minX) * scaleX),
+                                       std::uint32_t((center.y - minY) * scaleY)),
+                            i };
+            }
+        }
+        std::sort(keys.begin() + bounds[run], keys.begin() + bounds[run + 1]);
+    });
+
+    mergeRuns(keys, bounds);
+
+    std::vector<std::size_t> result(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        result[i] = keys[i].second;
+    }
+    return result;
+}
+
+} // namespace hilbert_detail
+
+std::vector<std::size_t> hilbert_order(const feature_collection &collection, std::size_t threads) {
+    return hilbert_detail::order(
+        collection.size(), [&](std::size_t i) -> const geometry & { return collection[i].geometry; },
+        threads);
+}
+
+void hilbert_sort(feature_collection &collection, std::size_t threads) {
+    const auto order = hilbert_order(collection, threads);
+    feature_collection sorted;
+    sorted.reserve(collection.size());
+    for (std::size_t i : order) {
+        sorted.push_back(std::move(collection[i]));
+    }
+    collection.swap(sorted);
+}
+
+} // namespace geojson
+} // namespace mapbox
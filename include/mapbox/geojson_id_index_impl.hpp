@@ -0,0 +1,235 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/id_index.hpp>
+#include <mapbox/geojson_parallel_impl.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+namespace mapbox {
+namespace geojson {
+namespace id_index_detail {
+
+enum kind : std::uint8_t { Empty, Uint, Int, Double, String };
+
+// Strings are stored as their length followed by their characters.
+constexpr std::size_t length_bytes = sizeof(std::uint64_t);
+
+// Spreads the bits of a key over the whole hash, so nearby numbers land in distant slots.
+inline std::uint64_t mix(std::uint64_t key, std::uint8_t type) {
+    key += 0x9e3779b97f4a7c15ull * (type + 1);
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+    return key ^ (key >> 31);
+}
+
+} // namespace id_index_detail
+
+constexpr std::size_t id_index::npos;
+
+bool id_index::describe(const identifier &id, slot &result) {
+    using namespace id_index_detail;
+    result = slot{};
+    if (id.is<std::uint64_t>()) {
+        result.kind    = Uint;
+        result.payload = id.get<std::uint64_t>();
+    } else if (id.is<std::int64_t>()) {
+        result.kind    = Int;
+        result.payload = std::uint64_t(id.get<std::int64_t>());
+    } else if (id.is<double>()) {
+        const double number = id.get<double>();
+        if (std::isnan(number))
+            return false;
+        // -0.0 equals 0.0, so both are stored as 0.0.
+        const double normalized = number == 0 ? 0.0 : number;
+        result.kind = Double;
+        std::memcpy(&result.payload, &normalized, sizeof(double));
+    } else if (id.is<std::string>()) {
+        result.kind = String;
+        result.hash = mix(std::hash<std::string>()(id.get<std::string>()), String);
+        return true;
+    } else {
+        return false;
+    }
+    result.hash = mix(result.payload, result.kind);
+    return true;
+}
+
+bool id_index::sameString(std::uint64_t offset, const std::string &string) const {
+    std::uint64_t length;
+    std::memcpy(&length, strings_.data() + offset, id_index_detail::length_bytes);
+    return length == string.size() &&
+           std::memcmp(strings_.data() + offset + id_index_detail::length_bytes, string.data(), string.size()) == 0;
+}
+
+std::size_t id_index::appendString(const std::string &string) {
+    const std::size_t offset   = strings_.size();
+    const std::uint64_t length = string.size();
+    strings_.append(reinterpret_cast<const char *>(&length), id_index_detail::length_bytes);
+    strings_.append(string);
+    return offset;
+}
+
+// Probes from the slot the hash selects until the id or an empty slot is found. Tables are at
+// most three quarters full, so there always is an empty slot.
+std::size_t id_index::locate(const slot &probe, const std::string *string) const {
+    if (slots_.empty())
+        return npos;
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = probe.hash & mask;; i = (i + 1) & mask) {
+        const slot &current = slots_[i];
+        if (current.kind == id_index_detail::Empty)
+            return npos;
+        if (current.hash == probe.hash && current.kind == probe.kind &&
+            (probe.kind == id_index_detail::String ? sameString(current.payload, *string)
+                                                   : current.payload == probe.payload))
+            return i;
+    }
+}
+
+void id_index::place(const slot &added) {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t i          = added.hash & mask;
+    while (slots_[i].kind != id_index_detail::Empty) {
+        i = (i + 1) & mask;
+    }
+    slots_[i] = added;
+}
+
+void id_index::reserve(std::size_t count) {
+    std::size_t capacity = 16;
+    while (capacity / 4 * 3 < count) {
+        capacity *= 2;
+    }
+    if (capacity <= slots_.size())
+        return;
+
+    std::vector<slot> old(capacity, slot{});
+    old.swap(slots_);
+    for (const auto &entry : old) {
+        if (entry.kind != id_index_detail::Empty)
+            place(entry);
+    }
+}
+
+// Ids are described and their strings copied in parallel, then placed in the table in order.
+id_index::id_index(const feature_collection &collection, std::size_t threads) {
+    using namespace parallel_detail;
+
+    const std::size_t count = collection.size();
+    if (count >= std::numeric_limits<std::uint32_t>::max())
+        throw error("too many features for an id index");
+
+    const auto bounds      = splitRuns(count, threads, 4096);
+    const std::size_t runs = bounds.size() - 1;
+
+    std::vector<slot> entries(count);
+    std::vector<std::size_t> bytes(runs + 1, 0);
+    std::vector<std::size_t> described(runs, 0);
+    parallelFor(runs, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            if (!describe(collection[i].id, entries[i]))
+                continue;
+            entries[i].index = std::uint32_t(i);
+            ++described[run];
+            if (entries[i].kind == id_index_detail::String)
+                bytes[run + 1] += id_index_detail::length_bytes + collection[i].id.get<std::string>().size();
+        }
+    });
+    std::partial_sum(bytes.begin(), bytes.end(), bytes.begin());
+
+    strings_.resize(bytes.back());
+    parallelFor(runs, [&](std::size_t run) {
+        std::size_t offset = bytes[run];
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            if (entries[i].kind != id_index_detail::String)
+                continue;
+            const auto &string         = collection[i].id.get<std::string>();
+            const std::uint64_t length = string.size();
+            std::memcpy(&strings_[offset], &length, id_index_detail::length_bytes);
+            std::memcpy(&strings_[offset + id_index_detail::length_bytes], string.data(), string.size());
+            entries[i].payload = offset;
+            offset += id_index_detail::length_bytes + string.size();
+        }
+    });
+
+    reserve(std::accumulate(described.begin(), described.end(), std::size_t(0)));
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto &entry = entries[i];
+        if (entry.kind == id_index_detail::Empty)
+            continue;
+        const std::string *string =
+            entry.kind == id_index_detail::String ? &collection[i].id.get<std::string>() : nullptr;
+        if (locate(entry, string) == npos) {
+            place(entry);
+            ++size_;
+        }
+    }
+}
+
+std::size_t id_index::find(const identifier &id) const {
+    slot probe;
+    if (!describe(id, probe))
+        return npos;
+    const std::size_t found = locate(probe, id.is<std::string>() ? &id.get<std::string>() : nullptr);
+    return found == npos ? npos : slots_[found].index;
+}
+
+void id_index::insert(const identifier &id, std::size_t index) {
+    if (index >= std::numeric_limits<std::uint32_t>::max())
+        throw error("feature index too large for an id index");
+
+    slot added;
+    if (!describe(id, added))
+        return;
+    added.index = std::uint32_t(index);
+
+    const std::string *string = id.is<std::string>() ? &id.get<std::string>() : nullptr;
+    const std::size_t found   = locate(added, string);
+    if (found != npos) {
+        slots_[found].index = added.index;
+        return;
+    }
+
+    reserve(size_ + 1);
+    if (string)
+        added.payload = appendString(*string);
+    place(added);
+    ++size_;
+}
+
+// Later slots of the probe sequence are shifted back over the erased one, so that no empty slot
+// is left between an id and the slot its hash selects.
+bool id_index::erase(const identifier &id) {
+    slot probe;
+    if (!describe(id, probe))
+        return false;
+    std::size_t hole = locate(probe, id.is<std::string>() ? &id.get<std::string>() : nullptr);
+    if (hole == npos)
+        return false;
+
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = (hole + 1) & mask; slots_[i].kind != id_index_detail::Empty; i = (i + 1) & mask) {
+        const std::size_t home = slots_[i].hash & mask;
+        // The slot may move back unless its home lies cyclically after the hole.
+        const bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            slots_[hole] = slots_[i];
+            hole         = i;
+        }
+    }
+    slots_[hole] = slot{};
+    --size_;
+    return true;
+}
+
+std::size_t id_index::memory_usage() const {
+    return slots_.capacity() * sizeof(slot) + strings_.capacity();
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -2,6 +2,7 @@
 
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
+#include <mapbox/geojson_instrumentation_impl.hpp>
 
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
@@ -69,8 +70,122 @@ Cont convert(const rapidjson_value &json) {
     return points;
 }
 
+// Line strings and rings are checked while they are converted rather than in a separate pass.
+
+template <>
+line_string convert<line_string>(const rapidjson_value &json) {
+    if (!json.IsArray()) {
+        throw error("coordinates must be an array of points describing linestring or an array of "
+                    "arrays describing polygons and line strings.");
+    }
+    if (json.Size() < 2) {
+        throw error("A line string must have two or more coordinate points.");
+    }
+
+    line_string points;
+    points.reserve(json.Size());
+    for (auto &element : json.GetArray()) {
+        points.push_back(convert<point>(element));
+    }
+    return points;
+}
+
+template <>
+linear_ring convert<linear_ring>(const rapidjson_value &json) {
+    if (!json.IsArray()) {
+        throw error("Coordinates must be an array of arrays, each describing a polygon.");
+    }
+    if (json.Size() < 4) {
+        throw error("Polygon must be described by 4 or more coordinate points. Improper "
+                    "nesting can also lead to this error. Double check that the coordinates "
+                    "are properly nested and there are 4 or more coordinates.");
+    }
+
+    linear_ring points;
+    points.reserve(json.Size());
+    for (auto &element : json.GetArray()) {
+        points.push_back(convert<point>(element));
+    }
+    return points;
+}
+
+template <>
+polygon convert<polygon>(const rapidjson_value &json) {
+    // this check is required incase case of multipolygon validation
+    if (!json.IsArray()) {
+        throw error("Coordinates must be nested more deeply.");
+    }
+
+    polygon rings;
+    rings.reserve(json.Size());
+    for (auto &element : json.GetArray()) {
+        rings.push_back(convert<linear_ring>(element));
+    }
+    return rings;
+}
+
+template <>
+geometry convert<geometry>(const rapidjson_value &json);
+
+bool isGeometryCollection(const rapidjson_value &json) {
+    if (!json.IsObject())
+        return false;
+    const auto &type_itr = json.FindMember("type");
+    return type_itr != json.MemberEnd() && type_itr->value == "GeometryCollection";
+}
+
+const rapidjson_value &geometryCollectionMembers(const rapidjson_value &json) {
+    const auto &geometries_itr = json.FindMember("geometries");
+    if (geometries_itr == json.MemberEnd())
+        throw error("GeometryCollection must have a geometries property");
+
+    const auto &json_geometries = geometries_itr->value;
+
+    if (!json_geometries.IsArray())
+        throw error("GeometryCollection geometries property must be an array");
+
+    return json_geometries;
+}
+
+// Nested collections are converted with an explicit stack rather than by recursing, so the
+// depth of the input doesn't bound the depth of the call stack.
+geometry_collection convertGeometryCollection(const rapidjson_value &json_geometries) {
+    struct frame {
+        const rapidjson_value *geometries;
+        rapidjson::SizeType next;
+        geometry_collection result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &json_geometries, 0, {} });
+    stack.back().result.reserve(json_geometries.Size());
+
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.geometries->Size()) {
+            geometry_collection done = std::move(top.result);
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+            stack.back().result.emplace_back(std::move(done));
+            continue;
+        }
+
+        const auto &element = (*top.geometries)[top.next++];
+        if (isGeometryCollection(element)) {
+            const auto &members = geometryCollectionMembers(element);
+            stack.push_back({ &members, 0, {} });
+            stack.back().result.reserve(members.Size());
+        } else {
+            top.result.push_back(convert<geometry>(element));
+        }
+    }
+}
+
 template <>
 geometry convert<geometry>(const rapidjson_value &json) {
+    phase_timer timer(phase::Geometry);
+
     if (json.IsNull())
         return empty{};
 
@@ -85,18 +200,8 @@ geometry convert<geometry>(const rapidjson_value &json) {
 
     const auto &type = type_itr->value;
 
-    if (type == "GeometryCollection") {
-        const auto &geometries_itr = json.FindMember("geometries");
-        if (geometries_itr == json_end)
-            throw error("GeometryCollection must have a geometries property");
-
-        const auto &json_geometries = geometries_itr->value;
-
-        if (!json_geometries.IsArray())
-            throw error("GeometryCollection geometries property must be an array");
-
-        return geometry{ convert<geometry_collection>(json_geometries) };
-    }
+    if (type == "GeometryCollection")
+        return geometry{ convertGeometryCollection(geometryCollectionMembers(json)) };
 
     const auto &coords_itr = json.FindMember("coordinates");
 
@@ -111,26 +216,14 @@ geometry convert<geometry>(const rapidjson_value &json) {
         return geometry{ convert<point>(json_coords) };
     if (type == "MultiPoint")
         return geometry{ convert<multi_point>(json_coords) };
-    if (type == "LineString") {
-        validateLineString(json_coords);
+    if (type == "LineString")
         return geometry{ convert<line_string>(json_coords) };
-    }
-    if (type == "MultiLineString") {
-        for (auto &element : json_coords.GetArray()) {
-            validateLineString(element);
-        }
+    if (type == "MultiLineString")
         return geometry{ convert<multi_line_string>(json_coords) };
-    }
-    if (type == "Polygon") {
-        validatePolygon(json_coords);
+    if (type == "Polygon")
         return geometry{ convert<polygon>(json_coords) };
-    }
-    if (type == "MultiPolygon") {
-        for (auto &element: json_coords.GetArray()) {
-            validatePolygon(element);
-        }
+    if (type == "MultiPolygon")
         return geometry{ convert<multi_polygon>(json_coords) };
-    }
     throw error(std::string(type.GetString()) + " not yet implemented");
 }
 
@@ -150,8 +243,8 @@ prop_map convert(const rapidjson_value &json) {
     return result;
 }
 
-template <>
-value convert<value>(const rapidjson_value &json) {
+// Converts null, boolean, string and number values.
+value convertScalar(const rapidjson_value &json) {
     switch (json.GetType()) {
     case rapidjson::kNullType:
         return null_value_t{};
@@ -159,10 +252,6 @@ value convert<value>(const rapidjson_value &json) {
         return false;
     case rapidjson::kTrueType:
         return true;
-    case rapidjson::kObjectType:
-        return convert<prop_map>(json);
-    case rapidjson::kArrayType:
-        return convert<std::vector<value>>(json);
     case rapidjson::kStringType:
         return std::string(json.GetString(), json.GetStringLength());
     default:
@@ -175,6 +264,73 @@ value convert<value>(const rapidjson_value &json) {
     }
 }
 
+// Arrays and objects are converted with an explicit stack rather than by recursing, so the
+// nesting depth of the input doesn't bound the depth of the call stack.
+template <>
+value convert<value>(const rapidjson_value &json) {
+    if (!json.IsArray() && !json.IsObject())
+        return convertScalar(json);
+
+    // A container being filled, and the index of its next element or member.
+    struct frame {
+        const rapidjson_value *json;
+        rapidjson::SizeType next;
+        std::vector<value> array;
+        prop_map object;
+    };
+
+    const auto sizeOf = [](const rapidjson_value &container) {
+        return container.IsArray() ? container.Size() : container.MemberCount();
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &json, 0, {}, {} });
+    if (json.IsArray())
+        stack.back().array.reserve(json.Size());
+
+    while (true) {
+        auto &top = stack.back();
+        const bool isArray = top.json->IsArray();
+
+        if (top.next == sizeOf(*top.json)) {
+            value done = isArray ? value{ std::move(top.array) } : value{ std::move(top.object) };
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+
+            auto &parent = stack.back();
+            if (parent.json->IsArray()) {
+                parent.array.push_back(std::move(done));
+            } else {
+                const auto &name = (parent.json->MemberBegin() + (parent.next - 1))->name;
+                parent.object.emplace(std::string(name.GetString(), name.GetStringLength()),
+                                      std::move(done));
+            }
+            continue;
+        }
+
+        const rapidjson_value *element;
+        if (isArray) {
+            element = &(*top.json)[top.next];
+        } else {
+            element = &(top.json->MemberBegin() + top.next)->value;
+        }
+        ++top.next;
+
+        if (element->IsArray() || element->IsObject()) {
+            stack.push_back({ element, 0, {}, {} });
+            if (element->IsArray())
+                stack.back().array.reserve(element->Size());
+        } else if (isArray) {
+            top.array.push_back(convertScalar(*element));
+        } else {
+            const auto &name = (top.json->MemberBegin() + (top.next - 1))->name;
+            top.object.emplace(std::string(name.GetString(), name.GetStringLength()),
+                               convertScalar(*element));
+        }
+    }
+}
+
 template <>
 identifier convert<identifier>(const rapidjson_value &json) {
     switch (json.GetType()) {
@@ -210,6 +366,7 @@ feature convert<feature>(const rapidjson_value &json) {
         throw error("Feature must have a geometry property");
 
     feature result{ convert<geometry>(geom_itr->value) };
+    phase_timer timer(phase::Properties);
 
     auto const &id_itr = json.FindMember("id");
     if (id_itr != json_end) {
@@ -271,7 +428,7 @@ geojson convert<geojson>(const rapidjson_value &json) {
 template <class T>
 T parse(const std::string &json) {
     rapidjson_document d;
-    d.Parse(json.c_str());
+    d.Parse<rapidjson::kParseIterativeFlag>(json.c_str());
     if (d.HasParseError()) {
         std::stringstream message;
         message << d.GetErrorOffset() << " - " << rapidjson::GetParseError_En(d.GetParseError());
@@ -410,32 +567,87 @@ struct to_value {
     }
 
     rapidjson_value operator()(const std::vector<value>& array) {
+        return nested(open(&array, nullptr));
+    }
+
+    rapidjson_value operator()(const std::unordered_map<std::string, value>& map) {
+        return nested(open(nullptr, &map));
+    }
+
+private:
+    // An array or object being converted, and its next element. Exactly one of array and object
+    // is set.
+    struct frame {
+        const std::vector<value>* array;
+        const std::unordered_map<std::string, value>* object;
+        std::vector<value>::const_iterator nextItem;
+        std::unordered_map<std::string, value>::const_iterator nextMember;
         rapidjson_value result;
-        result.SetArray();
-        for (const auto& item : array) {
-            result.PushBack(value::visit(item, *this), allocator);
+    };
+
+    static frame open(const std::vector<value>* array,
+                      const std::unordered_map<std::string, value>* object) {
+        frame result{ array, object, {}, {}, rapidjson_value() };
+        if (array) {
+            result.nextItem = array->begin();
+            result.result.SetArray();
+        } else {
+            result.nextMember = object->begin();
+            result.result.SetObject();
         }
         return result;
     }
 
-    rapidjson_value operator()(const std::unordered_map<std::string, value>& map) {
-        rapidjson_value result;
-        result.SetObject();
-        for (const auto& property : map) {
-            result.AddMember(
-                rapidjson::GenericStringRef<char> {
-                    property.first.data(),
-                    rapidjson::SizeType(property.first.size())
-                },
-                value::visit(property.second, *this),
+    // Appends a converted element to its container and moves on to the next one.
+    void add(frame& container, rapidjson_value&& element) {
+        if (container.array) {
+            container.result.PushBack(element, allocator);
+            ++container.nextItem;
+        } else {
+            const auto& key = container.nextMember->first;
+            container.result.AddMember(
+                rapidjson::GenericStringRef<char> { key.data(), rapidjson::SizeType(key.size()) },
+                element,
                 allocator);
+            ++container.nextMember;
+        }
+    }
+
+    // Arrays and objects are converted with an explicit stack rather than by recursing, so the
+    // nesting depth of the input doesn't bound the depth of the call stack.
+    rapidjson_value nested(frame&& outermost) {
+        std::vector<frame> stack;
+        stack.push_back(std::move(outermost));
+
+        while (true) {
+            auto& top = stack.back();
+            const bool done = top.array ? top.nextItem == top.array->end()
+                                        : top.nextMember == top.object->end();
+            if (done) {
+                rapidjson_value result(std::move(top.result));
+                stack.pop_back();
+                if (stack.empty())
+                    return result;
+                add(stack.back(), std::move(result));
+                continue;
+            }
+
+            const value& element = top.array ? *top.nextItem : top.nextMember->second;
+            if (element.is<value::array_type>()) {
+                stack.push_back(open(&element.get<value::array_type>(), nullptr));
+            } else if (element.is<value::object_type>()) {
+                stack.push_back(open(nullptr, &element.get<value::object_type>()));
+            } else {
+                add(top, value::visit(element, *this));
+            }
         }
-        return result;
     }
 };
 
 template <>
 rapidjson_value convert<geometry>(const geometry& element, rapidjson_allocator& allocator) {
+    phase_timer timer(phase::Geometry);
+
     if (element.is<empty>())
         return rapidjson_value(rapidjson::kNullType);
 
@@ -454,21 +666,31 @@ rapidjson_value convert<geometry>(const geometry& element, rapidjson_allocator&
     return result;
 }
 
-template <>
-rapidjson_value convert<feature>(const feature& element, rapidjson_allocator& allocator) {
+rapidjson_value convertFeature(const identifier& id,
+                               const geometry& shape,
+                               const prop_map& properties,
+                               rapidjson_allocator& allocator) {
     rapidjson_value result(rapidjson::kObjectType);
     result.AddMember("type", "Feature", allocator);
 
-    if (!element.id.is<null_value_t>()) {
-        result.AddMember("id", identifier::visit(element.id, to_value { allocator }), allocator);
+    if (!id.is<null_value_t>()) {
+        phase_timer timer(phase::Properties);
+        result.AddMember("id", identifier::visit(id, to_value { allocator }), allocator);
     }
 
-    result.AddMember("geometry", convert(element.geometry, allocator), allocator);
-    result.AddMember("properties", to_value { allocator }(element.properties), allocator);
+    result.AddMember("geometry", convert(shape, allocator), allocator);
+
+    phase_timer timer(phase::Properties);
+    result.AddMember("properties", to_value { allocator }(properties), allocator);
 
     return result;
 }
 
+template <>
+rapidjson_value convert<feature>(const feature& element, rapidjson_allocator& allocator) {
+    return convertFeature(element.id, element.geometry, element.properties, allocator);
+}
+
 template <>
 rapidjson_value convert<feature_collection>(const feature_collection& collection, rapidjson_allocator& allocator) {
     rapidjson_value result(rapidjson::kObjectType);
@@ -504,5 +726,68 @@ std::string stringify(const geojson& element) {
     });
 }
 
+geojson parse(const std::string &json, instrumentation_stats &stats, instrumentation_hook *hook) {
+    stats = instrumentation_stats{};
+    if (hook)
+        hook->begin_parse();
+
+    const auto start = instrumentation_clock::now();
+    auto finish = [&] {
+        stats.total_time = instrumentation_clock::now() - start;
+        if (hook)
+            hook->end_parse(stats);
+    };
+
+    phase_recorder recorder(stats);
+    stats.bytes = json.size();
+    geojson result;
+    try {
+        rapidjson_document d;
+        {
+            phase_timer timer(phase::Tokenize);
+            d.Parse<rapidjson::kParseIterativeFlag>(json.c_str());
+        }
+        if (d.HasParseError()) {
+            std::stringstream message;
+            message << d.GetErrorOffset() << " - " << rapidjson::GetParseError_En(d.GetParseError());
+            throw error(message.str());
+        }
+        result = convert<geojson>(d);
+    } catch (...) {
+        finish();
+        throw;
+    }
+
+    geojson::visit(result, content_counter{ stats });
+    finish();
+    return result;
+}
+
+std::string stringify(const geojson &element, instrumentation_stats &stats, instrumentation_hook *hook) {
+    stats = instrumentation_stats{};
+    if (hook)
+        hook->begin_stringify();
+
+    const auto start = instrumentation_clock::now();
+    phase_recorder recorder(stats);
+    geojson::visit(element, content_counter{ stats });
+
+    rapidjson_allocator allocator;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    const rapidjson_value document = convert(element, allocator);
+    {
+        phase_timer timer(phase::Write);
+        document.Accept(writer);
+    }
+    std::string result = buffer.GetString();
+
+    stats.bytes      = result.size();
+    stats.total_time = instrumentation_clock::now() - start;
+    if (hook)
+        hook->end_stringify(stats);
+    return result;
+}
+
 } // namespace geojson
 } // namespace mapbox
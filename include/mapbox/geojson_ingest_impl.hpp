@@ -0,0 +1,322 @@
+#pragma once
+
+#include <mapbox/geojson_builder_impl.hpp>
+#include <mapbox/geojson_scanner_impl.hpp>
+#include <mapbox/geojson/ingest.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace mapbox {
+namespace geojson {
+namespace ingest_detail {
+
+// A file mapped read-only into memory for as long as the object lives.
+class mapped_file {
+public:
+    explicit mapped_file(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "failed to open " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            const int code = errno;
+            ::close(fd);
+            throw std::system_error(code, std::generic_category(), "failed to read " + path);
+        }
+
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                const int code = errno;
+                ::close(fd);
+                throw std::system_error(code, std::generic_category(), "failed to map " + path);
+            }
+            data_ = static_cast<const char *>(mapped);
+        }
+        ::close(fd);
+    }
+
+    ~mapped_file() {
+        if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    const char *data() const {
+        return data_;
+    }
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Either a file still to be opened, or a run of features of a file that has been split.
+struct task {
+    std::size_t file = 0;
+    std::shared_ptr<const mapped_file> text;
+    // Index of the first feature of the run.
+    std::size_t first = 0;
+    std::vector<features_scanner::range> features;
+};
+
+// The tasks of one worker. The owner takes from the back, and other workers steal from the
+// front, where the tasks that have waited longest are.
+struct task_queue {
+    std::mutex mutex;
+    std::deque<task> tasks;
+};
+
+class scheduler {
+public:
+    scheduler(const std::vector<std::string> &paths,
+              const ingest_callback &callback,
+              const ingest_options &options)
+        : paths_(paths),
+          callback_(callback),
+          options_(options),
+          queues_(options.threads ? options.threads
+                                  : std::max(1u, std::thread::hardware_concurrency())),
+          failures_(paths.size()),
+          failed_(new std::atomic<bool>[paths.size()]) {
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            failed_[i] = false;
+        }
+    }
+
+    std::vector<std::exception_ptr> run() {
+        // Larger files are handed out first, in turn, so they start early on every worker.
+        std::vector<std::pair<std::size_t, std::size_t>> sizes;
+        sizes.reserve(paths_.size());
+        for (std::size_t i = 0; i < paths_.size(); ++i) {
+            struct stat info;
+            const bool found = ::stat(paths_[i].c_str(), &info) == 0;
+            sizes.emplace_back(found ? static_cast<std::size_t>(info.st_size) : 0, i);
+        }
+        std::sort(sizes.begin(), sizes.end(), [](const auto &a, const auto &b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            task opening;
+            opening.file = sizes[i].second;
+            queues_[i % queues_.size()].tasks.push_back(std::move(opening));
+        }
+        pending_ = paths_.size();
+
+        // The calling thread is the first worker. If fewer threads can be started, the ones
+        // that run steal the rest of the work.
+        std::vector<std::thread> workers;
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            try {
+                workers.emplace_back([this, i] { work(i); });
+            } catch (const std::system_error &) {
+                break;
+            }
+        }
+        work(0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        return std::move(failures_);
+    }
+
+private:
+    // Workers with nothing to take sleep until a task is pushed or the last one finishes. The
+    // count of pushes is read before looking for work, so a push made after the search failed
+    // still wakes the worker.
+    void work(std::size_t self) {
+        reusable_parser parser(options_.parsing, true);
+        task current;
+        while (true) {
+            const std::size_t seen = pushes_.load();
+            if (take(self, current)) {
+                execute(self, parser, current);
+                current = task{};
+                if (pending_.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idleMutex_);
+                    idle_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            idle_.wait(lock, [&] { return pending_.load() == 0 || pushes_.load() != seen; });
+            if (pending_.load() == 0)
+                return;
+        }
+    }
+
+    bool take(std::size_t self, task &result) {
+        {
+            auto &own = queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                result = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            auto &other = queues_[(self + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty()) {
+                result = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void push(std::size_t self, task &&added) {
+        pending_.fetch_add(1);
+        {
+            auto &own = queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.tasks.push_back(std::move(added));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            pushes_.fetch_add(1);
+        }
+        idle_.notify_one();
+    }
+
+    void execute(std::size_t self, reusable_parser &parser, const task &current) {
+        if (failed_[current.file])
+            return;
+        try {
+            if (current.text) {
+                parseFeatures(parser, current);
+            } else {
+                open(self, parser, current.file);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failuresMutex_);
+            if (!failures_[current.file])
+                failures_[current.file] = std::current_exception();
+            failed_[current.file] = true;
+        }
+    }
+
+    // Small files are parsed at once. Large FeatureCollections are scanned for their features,
+    // which are then split into runs for the workers to take. With a filter, FeatureCollections
+    // of any size are scanned, so features keep their index in the file.
+    void open(std::size_t self, reusable_parser &parser, std::size_t file) {
+        auto text = std::make_shared<const mapped_file>(paths_[file]);
+        checkInputSize(text->size(), options_.parsing);
+
+        if (text->size() > options_.unit_bytes || options_.parsing.filter) {
+            features_scanner scanner;
+            std::vector<features_scanner::range> features;
+            scanner.scan(text->data(), text->size(), features);
+            if (scanner.found()) {
+                if (!scanner.ended())
+                    throw error("incomplete GeoJSON document");
+                split(self, file, text, features);
+                return;
+            }
+        }
+
+        geojson parsed = parser.parse(text->data(), text->size());
+        if (parser.rejected())
+            return;
+        if (parsed.is<feature>()) {
+            callback_(file, 0, std::move(parsed.get<feature>()));
+        } else if (parsed.is<feature_collection>()) {
+            auto &collection = parsed.get<feature_collection>();
+            for (std::size_t i = 0; i < collection.size(); ++i) {
+                callback_(file, i, std::move(collection[i]));
+            }
+        } else {
+            throw error("GeoJSON must be a Feature or FeatureCollection");
+        }
+    }
+
+    void split(std::size_t self,
+               std::size_t file,
+               const std::shared_ptr<const mapped_file> &text,
+               const std::vector<features_scanner::range> &features) {
+        task run;
+        std::size_t bytes = 0;
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            if (run.features.empty()) {
+                run.file  = file;
+                run.text  = text;
+                run.first = i;
+            }
+            run.features.push_back(features[i]);
+            bytes += features[i].end - features[i].begin;
+            if (bytes >= options_.unit_bytes) {
+                push(self, std::move(run));
+                run   = task{};
+                bytes = 0;
+            }
+        }
+        if (!run.features.empty())
+            push(self, std::move(run));
+    }
+
+    void parseFeatures(reusable_parser &parser, const task &run) {
+        const char *data = run.text->data();
+        for (std::size_t i = 0; i < run.features.size(); ++i) {
+            if (failed_[run.file])
+                return;
+            const auto &range = run.features[i];
+            geojson parsed    = parser.parse(data + range.begin, range.end - range.begin);
+            if (parser.rejected())
+                continue;
+            if (!parsed.is<feature>())
+                throw error("FeatureCollection features must be Features");
+            callback_(run.file, run.first + i, std::move(parsed.get<feature>()));
+        }
+    }
+
+    const std::vector<std::string> &paths_;
+    const ingest_callback &callback_;
+    const ingest_options &options_;
+
+    std::vector<task_queue> queues_;
+    // Tasks queued or running; the workers stop once it reaches zero.
+    std::atomic<std::size_t> pending_{ 0 };
+    // Tasks pushed while running, changed with idleMutex_ held.
+    std::atomic<std::size_t> pushes_{ 0 };
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+
+    std::mutex failuresMutex_;
+    std::vector<std::exception_ptr> failures_;
+    std::unique_ptr<std::atomic<bool>[]> failed_;
+};
+
+} // namespace ingest_detail
+
+std::vector<std::exception_ptr>
+ingest(const std::vector<std::string> &paths, const ingest_callback &callback, const ingest_options &options) {
+    return ingest_detail::scheduler(paths, callback, options).run();
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/instrumentation.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+namespace {
+
+using instrumentation_clock = std::chrono::steady_clock;
+
+enum class phase { Tokenize, Geometry, Properties, Write };
+
+// Collects phase times for the instrumented call running on this thread.
+class phase_recorder {
+public:
+    explicit phase_recorder(instrumentation_stats &stats) : stats_(stats), previous_(active()) {
+        active() = this;
+    }
+    ~phase_recorder() {
+        active() = previous_;
+    }
+
+    static phase_recorder *&active() {
+        static thread_local phase_recorder *recorder = nullptr;
+        return recorder;
+    }
+
+    std::chrono::nanoseconds &time(phase p) {
+        switch (p) {
+        case phase::Tokenize:
+            return stats_.tokenize_time;
+        case phase::Geometry:
+            return stats_.geometry_time;
+        case phase::Properties:
+            return stats_.property_time;
+        case phase::Write:
+            break;
+        }
+        return stats_.write_time;
+    }
+
+    // Only the outermost phase is timed, so nested geometry collections and geometries inside
+    // features are not counted twice.
+    bool timing = false;
+
+private:
+    instrumentation_stats &stats_;
+    phase_recorder *previous_;
+};
+
+// Adds the time until it goes out of scope to a phase of the active recorder, if there is one.
+class phase_timer {
+public:
+    explicit phase_timer(phase p) {
+#if MAPBOX_GEOJSON_INSTRUMENTATION
+        auto *recorder = phase_recorder::active();
+        if (recorder && !recorder->timing) {
+            recorder_        = recorder;
+            phase_           = p;
+            start_           = instrumentation_clock::now();
+            recorder->timing = true;
+        }
+#else
+        (void)p;
+#endif
+    }
+
+    ~phase_timer() {
+        if (recorder_) {
+            recorder_->time(phase_) += instrumentation_clock::now() - start_;
+            recorder_->timing = false;
+        }
+    }
+
+    phase_timer(const phase_timer &) = delete;
+    phase_timer &operator=(const phase_timer &) = delete;
+
+private:
+    phase_recorder *recorder_ = nullptr;
+    phase phase_              = phase::Tokenize;
+    instrumentation_clock::time_point start_;
+};
+
+// Fills the feature, vertex and property counts of stats from a parsed or stringified object.
+class content_counter {
+public:
+    explicit content_counter(instrumentation_stats &stats) : stats_(stats) {
+    }
+
+    void operator()(const geometry &root) {
+        pending_.assign(1, &root);
+        while (!pending_.empty()) {
+            const geometry &element = *pending_.back();
+            pending_.pop_back();
+            element.match(
+                [&](const geometry_collection &collection) {
+                    for (const auto &child : collection) {
+                        pending_.push_back(&child);
+                    }
+                },
+                [&](const auto &alternative) { count(alternative); });
+        }
+    }
+
+    void operator()(const feature &element) {
+        ++stats_.features;
+        stats_.properties += element.properties.size();
+        (*this)(element.geometry);
+    }
+
+    void operator()(const feature_collection &collection) {
+        for (const auto &element : collection) {
+            (*this)(element);
+        }
+    }
+
+private:
+    void count(const empty &) {
+    }
+
+    void count(const point &) {
+        ++stats_.vertices;
+    }
+
+    void count(const std::vector<point> &points) {
+        stats_.vertices += points.size();
+    }
+
+    template <class T>
+    void count(const std::vector<T> &parts) {
+        for (const auto &part : parts) {
+            count(part);
+        }
+    }
+
+    instrumentation_stats &stats_;
+    std::vector<const geometry *> pending_;
+};
+
+} // namespace
+
+} // namespace geojson
+} // namespace mapbox
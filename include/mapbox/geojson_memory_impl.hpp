@@ -0,0 +1,169 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/memory.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+namespace {
+
+std::size_t stringUsage(const std::string &string) {
+    static const std::size_t inlineCapacity = std::string().capacity();
+    return string.capacity() > inlineCapacity ? string.capacity() + 1 : 0;
+}
+
+// A node holds the next pointer, the cached hash of the key and the member. A single bucket is
+// stored inline.
+std::size_t mapUsage(const value::object_type &map) {
+    const std::size_t node = sizeof(void *) + sizeof(std::size_t) + sizeof(value::object_type::value_type);
+    return (map.bucket_count() > 1 ? map.bucket_count() * sizeof(void *) : 0) + map.size() * node;
+}
+
+std::size_t propertiesUsage(const value::object_type &properties) {
+    std::size_t total = mapUsage(properties);
+    for (const auto &member : properties) {
+        total += stringUsage(member.first) + memory_usage(member.second);
+    }
+    return total;
+}
+
+std::size_t coordinatesUsage(const empty &) {
+    return 0;
+}
+
+std::size_t coordinatesUsage(const point &) {
+    return 0;
+}
+
+std::size_t coordinatesUsage(const std::vector<point> &points) {
+    return points.capacity() * sizeof(point);
+}
+
+template <class T>
+std::size_t coordinatesUsage(const std::vector<T> &parts) {
+    std::size_t total = parts.capacity() * sizeof(T);
+    for (const auto &part : parts) {
+        total += coordinatesUsage(part);
+    }
+    return total;
+}
+
+} // namespace
+
+// Nested collections and values are walked with an explicit stack, like the conversions.
+std::size_t memory_usage(const geometry &root) {
+    std::size_t total = 0;
+    std::vector<const geometry *> pending{ &root };
+    while (!pending.empty()) {
+        const geometry &element = *pending.back();
+        pending.pop_back();
+        element.match(
+            [&](const geometry_collection &collection) {
+                total += collection.capacity() * sizeof(geometry);
+                for (const auto &child : collection) {
+                    pending.push_back(&child);
+                }
+            },
+            [&](const auto &alternative) { total += coordinatesUsage(alternative); });
+    }
+    return total;
+}
+
+std::size_t memory_usage(const value &root) {
+    std::size_t total = 0;
+    std::vector<const value *> pending{ &root };
+    while (!pending.empty()) {
+        const value &element = *pending.back();
+        pending.pop_back();
+        if (const auto *string = element.getString()) {
+            total += stringUsage(*string);
+        } else if (const auto *array = element.getArray()) {
+            total += sizeof(value::array_type) + array->capacity() * sizeof(value);
+            for (const auto &item : *array) {
+                pending.push_back(&item);
+            }
+        } else if (const auto *object = element.getObject()) {
+            total += sizeof(value::object_type) + mapUsage(*object);
+            for (const auto &member : *object) {
+                total += stringUsage(member.first);
+                pending.push_back(&member.second);
+            }
+        }
+    }
+    return total;
+}
+
+std::size_t memory_usage(const feature &element) {
+    std::size_t total = memory_usage(element.geometry) + propertiesUsage(element.properties);
+    if (element.id.is<std::string>()) {
+        total += stringUsage(element.id.get<std::string>());
+    }
+    return total;
+}
+
+std::size_t memory_usage(const feature_collection &collection) {
+    std::size_t total = collection.capacity() * sizeof(feature);
+    for (const auto &element : collection) {
+        total += memory_usage(element);
+    }
+    return total;
+}
+
+std::size_t memory_usage(const geojson &element) {
+    return geojson::visit(element, [](const auto &alternative) { return memory_usage(alternative); });
+}
+
+namespace {
+
+thread_local allocation_counter *activeCounter = nullptr;
+
+} // namespace
+
+allocation_counter::allocation_counter() : previous_(activeCounter) {
+    activeCounter = this;
+}
+
+// Folds the counts into the enclosing counter, whose peak may have been reached in this scope.
+allocation_counter::~allocation_counter() {
+    activeCounter = previous_;
+    if (previous_) {
+        previous_->stats_.allocations += stats_.allocations;
+        previous_->stats_.bytes += stats_.bytes;
+        previous_->stats_.peak_bytes =
+            std::max<std::size_t>(previous_->stats_.peak_bytes,
+                                  std::max<std::ptrdiff_t>(0, previous_->live_ + std::ptrdiff_t(stats_.peak_bytes)));
+        previous_->live_ += live_;
+    }
+}
+
+void allocation_counter::allocated(std::size_t size) noexcept {
+    if (auto *counter = activeCounter) {
+        ++counter->stats_.allocations;
+        counter->stats_.bytes += size;
+        counter->live_ += std::ptrdiff_t(size);
+        if (counter->live_ > 0) {
+            counter->stats_.peak_bytes =
+                std::max(counter->stats_.peak_bytes, std::size_t(counter->live_));
+        }
+    }
+}
+
+void allocation_counter::deallocated(std::size_t size) noexcept {
+    if (auto *counter = activeCounter) {
+        counter->live_ -= std::ptrdiff_t(size);
+    }
+}
+
+geojson parse(const std::string &json, const parse_options &options, allocation_stats &stats) {
+    allocation_counter counter;
+    geojson result = parse(json, options);
+    stats          = counter.stats();
+    return result;
+}
+
+} // namespace geojson
+} // namespace mapbox
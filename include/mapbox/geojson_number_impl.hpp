@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace mapbox {
+namespace geojson {
+
+// Converts the text of JSON numbers, which rapidjson has already validated, to doubles.
+//
+// Up to 19 significant digits are accumulated exactly into an integer mantissa, eight digits at a
+// time where the input allows it. When the mantissa fits in 53 bits and the power of ten is at
+// most 22 the conversion is a single correctly rounded multiplication or division (Clinger's fast
+// path), which covers the coordinates most encoders emit. Other inputs go to strtod when full
+// precision is required, and are otherwise approximated to within a few units in the last place.
+class number_parser {
+public:
+    explicit number_parser(bool fullPrecision) : fullPrecision_(fullPrecision) {
+    }
+
+    double parse(const char *str, std::size_t length) const {
+        const char *p         = str;
+        const char *const end = str + length;
+
+        const bool negative = *p == '-';
+        if (negative)
+            ++p;
+
+        std::uint64_t mantissa = 0;
+        int digits             = 0;
+        int exponent           = 0;
+        bool truncated         = false;
+
+        p = accumulate(p, end, mantissa, digits, truncated, exponent, false);
+        if (p != end && *p == '.') {
+            p = accumulate(p + 1, end, mantissa, digits, truncated, exponent, true);
+        }
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            const bool negativeExponent = *p == '-';
+            if (*p == '-' || *p == '+')
+                ++p;
+            int explicitExponent = 0;
+            for (; p != end; ++p) {
+                if (explicitExponent < 100000)
+                    explicitExponent = explicitExponent * 10 + (*p - '0');
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if (mantissa == 0)
+            return negative ? -0.0 : 0.0;
+
+        if (!truncated && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+            double result = double(mantissa);
+            result = exponent < 0 ? result / powersOfTen[-exponent] : result * powersOfTen[exponent];
+            return negative ? -result : result;
+        }
+
+        if (!fullPrecision_ && exponent >= -300 && exponent <= 300) {
+            double result = double(mantissa);
+            result = exponent < 0 ? result / std::pow(10.0, -exponent) : result * std::pow(10.0, exponent);
+            return negative ? -result : result;
+        }
+
+        return fallback(str, length);
+    }
+
+private:
+    static constexpr int maxDigits = 19;
+
+    static constexpr double powersOfTen[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    static constexpr bool swar = true;
+#else
+    static constexpr bool swar = false;
+#endif
+
+    static bool isEightDigits(std::uint64_t chunk) {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+                (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    }
+
+    // Value of eight ASCII digits loaded little endian, combining pairs, then quadruples.
+    static std::uint64_t parseEightDigits(std::uint64_t chunk) {
+        chunk -= 0x3030303030303030;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+                 (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+                32;
+        return chunk;
+    }
+
+    // Consumes a run of digits. Digits beyond the 19th significant one are dropped; in the integer
+    // part each dropped digit scales the result by ten instead.
+    static const char *accumulate(const char *p,
+                                  const char *end,
+                                  std::uint64_t &mantissa,
+                                  int &digits,
+                                  bool &truncated,
+                                  int &exponent,
+                                  bool fraction) {
+        while (p != end && *p >= '0' && *p <= '9') {
+            if (swar && mantissa != 0 && digits + 8 <= maxDigits && end - p >= 8) {
+                std::uint64_t chunk;
+                std::memcpy(&chunk, p, sizeof(chunk));
+                if (isEightDigits(chunk)) {
+                    mantissa = mantissa * 100000000 + parseEightDigits(chunk);
+                    digits += 8;
+                    exponent -= fraction ? 8 : 0;
+                    p += 8;
+                    continue;
+                }
+            }
+            if (digits < maxDigits) {
+                mantissa = mantissa * 10 + std::uint64_t(*p - '0');
+                digits += mantissa != 0;
+                exponent -= fraction ? 1 : 0;
+            } else {
+                truncated = truncated || *p != '0';
+                exponent += fraction ? 0 : 1;
+            }
+            ++p;
+        }
+        return p;
+    }
+
+    static double fallback(const char *str, std::size_t length) {
+        char buffer[64];
+        if (length < sizeof(buffer)) {
+            std::memcpy(buffer, str, length);
+            buffer[length] = '\0';
+            return std::strtod(buffer, nullptr);
+        }
+        return std::strtod(std::string(str, length).c_str(), nullptr);
+    }
+
+    bool fullPrecision_;
+};
+
+constexpr double number_parser::powersOfTen[];
+
+// Parses the text of a JSON integer into result, returning false when the text has a fraction
+// or exponent or does not fit.
+bool parseUnsigned(const char *str, std::size_t length, std::uint64_t &result) {
+    result = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        const char c = str[i];
+        if (c < '0' || c > '9')
+            return false;
+        const std::uint64_t digit = std::uint64_t(c - '0');
+        if (result > (UINT64_MAX - digit) / 10)
+            return false;
+        result = result * 10 + digit;
+    }
+    return true;
+}
+
+} // namespace geojson
+} // namespace mapbox
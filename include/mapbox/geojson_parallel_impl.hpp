@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+namespace parallel_detail {
+
+// Bounds of runs that split count items between up to the given number of threads, zero meaning
+// one per hardware thread. Runs have at least the given number of items, so small inputs stay on
+// one thread.
+inline std::vector<std::size_t> splitRuns(std::size_t count, std::size_t threads, std::size_t minimum) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t runs = std::max<std::size_t>(1, std::min(threads, count / minimum));
+    std::vector<std::size_t> bounds(runs + 1);
+    for (std::size_t i = 0; i <= runs; ++i) {
+        bounds[i] = count * i / runs;
+    }
+    return bounds;
+}
+
+// Runs f(i) for each i below tasks, each on its own thread. The calling thread runs the first,
+// and any that no thread could be started for.
+template <class F>
+void parallelFor(std::size_t tasks, F f) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < tasks; ++i) {
+        try {
+            workers.emplace_back([&f, i] { f(i); });
+        } catch (const std::system_error &) {
+            f(i);
+        }
+    }
+    if (tasks > 0)
+        f(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Merges runs that are each sorted, pairwise and in parallel, leaving the whole range sorted.
+template <class T>
+void mergeRuns(std::vector<T> &items, const std::vector<std::size_t> &bounds) {
+    const std::size_t runs = bounds.size() - 1;
+    for (std::size_t width = 1; width < runs; width *= 2) {
+        parallelFor((runs + 2 * width - 1) / (2 * width), [&](std::size_t pair) {
+            const std::size_t first  = 2 * pair * width;
+            const std::size_t middle = std::min(first + width, runs);
+            const std::size_t end    = std::min(first + 2 * width, runs);
+            std::inplace_merge(items.begin() + bounds[first], items.begin() + bounds[middle],
+                               items.begin() + bounds[end]);
+        });
+    }
+}
+
+} // namespace parallel_detail
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mapbox/geojson/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mapbox {
+namespace geojson {
+
+namespace projection {
+
+constexpr double earthRadius = 6378137;
+constexpr double maxLatitude = 85.0511287798065923778;
+constexpr double pi          = 3.14159265358979323846;
+constexpr double degrees     = 180 / pi;
+constexpr double radians     = pi / 180;
+
+// Runs are projected in fixed size blocks. Each block copies one axis into a contiguous array so
+// the per-coordinate loops have no stride or aliasing, which lets the compiler vectorize them
+// (including the transcendental calls when a vector math library is enabled).
+constexpr std::size_t block = 64;
+
+} // namespace projection
+
+void lonlat_to_mercator(point *points, std::size_t size) {
+    using namespace projection;
+    double y[block];
+
+    for (std::size_t start = 0; start < size; start += block) {
+        point *run              = points + start;
+        const std::size_t count = std::min(block, size - start);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            y[i] = std::max(-maxLatitude, std::min(maxLatitude, run[i].y)) * radians;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            y[i] = earthRadius * std::log(std::tan(pi / 4 + y[i] / 2));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            run[i].x *= earthRadius * radians;
+            run[i].y = y[i];
+        }
+    }
+}
+
+void mercator_to_lonlat(point *points, std::size_t size) {
+    using namespace projection;
+    double y[block];
+
+    for (std::size_t start = 0; start < size; start += block) {
+        point *run              = points + start;
+        const std::size_t count = std::min(block, size - start);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            y[i] = run[i].y / earthRadius;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            y[i] = (2 * std::atan(std::exp(y[i])) - pi / 2) * degrees;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            run[i].x *= degrees / earthRadius;
+            run[i].y = y[i];
+        }
+    }
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mapbox/geojson_builder_impl.hpp>
+#include <mapbox/geojson_scanner_impl.hpp>
+#include <mapbox/geojson/push_parser.hpp>
+
+#include <sstream>
+
+namespace mapbox {
+namespace geojson {
+
+push_parser::push_parser(feature_callback callback,
+                         const parse_options &options,
+                         std::size_t max_buffer_bytes)
+    : callback_(std::move(callback)), options_(options), maxBuffer_(max_buffer_bytes) {
+}
+
+void push_parser::feed(const char *data, std::size_t size) {
+    if (options_.limits.max_input_bytes &&
+        scanner_.offset() + size > options_.limits.max_input_bytes) {
+        std::stringstream message;
+        message << "input exceeds the limit of " << options_.limits.max_input_bytes << " bytes";
+        throw limit_error(message.str());
+    }
+
+    buffer_.append(data, size);
+    scanner_.scan(data, size, features_);
+    parseFeatures();
+    compact();
+
+    if (maxBuffer_ && buffer_.size() > maxBuffer_) {
+        std::stringstream message;
+        message << "buffered input exceeds the limit of " << maxBuffer_ << " bytes";
+        throw limit_error(message.str());
+    }
+}
+
+void push_parser::parseFeatures() {
+    if (features_.empty())
+        return;
+    reusable_parser parser(options_, true);
+    for (const auto &range : features_) {
+        geojson parsed = parser.parse(buffer_.data() + (range.begin - base_), range.end - range.begin);
+        if (parser.rejected())
+            continue;
+        if (!parsed.is<feature>())
+            throw error("FeatureCollection features must be Features");
+        callback_(std::move(parsed.get<feature>()));
+    }
+    features_.clear();
+}
+
+// Once the features member has been found, the text that has been scanned won't be parsed again,
+// apart from the feature in progress.
+void push_parser::compact() {
+    if (!scanner_.found())
+        return;
+
+    std::size_t end = scanner_.offset();
+    if (scanner_.pending() != std::string::npos)
+        end = scanner_.pending();
+
+    buffer_.erase(0, end - base_);
+    base_ = end;
+}
+
+void push_parser::finish() {
+    if (!scanner_.found()) {
+        reusable_parser parser(options_, true);
+        geojson parsed = parser.parse(buffer_);
+        buffer_.clear();
+        if (parser.rejected())
+            return;
+        if (parsed.is<feature>()) {
+            callback_(std::move(parsed.get<feature>()));
+        } else if (parsed.is<feature_collection>()) {
+            for (auto &element : parsed.get<feature_collection>()) {
+                callback_(std::move(element));
+            }
+        } else {
+            throw error("GeoJSON must be a Feature or FeatureCollection");
+        }
+        return;
+    }
+
+    if (!scanner_.ended())
+        throw error("incomplete GeoJSON document");
+    buffer_.clear();
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <mapbox/geojson/scanner.hpp>
+
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace mapbox {
+namespace geojson {
+
+using error = std::runtime_error;
+
+void features_scanner::scan(const char *data, std::size_t size, std::vector<range> &features) {
+    for (std::size_t i = 0; i < size; ++i, ++offset_) {
+        const char c = data[i];
+
+        if (inString_) {
+            if (hexDigits_) {
+                if (!std::isxdigit(static_cast<unsigned char>(c)))
+                    fail("invalid escape in string");
+                codePoint_ = codePoint_ * 16 +
+                             unsigned(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+                if (--hexDigits_ == 0)
+                    appendCodePoint();
+            } else if (escaped_) {
+                static const char escapes[] = "\"\\/bfnrt";
+                static const char decoded[] = "\"\\/\b\f\n\r\t";
+                const char *escape          = c ? std::strchr(escapes, c) : nullptr;
+                escaped_                    = false;
+                if (c == 'u') {
+                    hexDigits_ = 4;
+                    codePoint_ = 0;
+                } else if (!escape) {
+                    fail("invalid escape in string");
+                } else {
+                    append(decoded[escape - escapes]);
+                }
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                fail("control character in string");
+            } else if (c == '\\') {
+                escaped_ = true;
+            } else if (c == '"') {
+                inString_ = false;
+                if (!featureDepth_)
+                    endString();
+            } else {
+                append(c);
+            }
+            continue;
+        }
+
+        if (featureDepth_) {
+            scanFeature(c, features);
+            continue;
+        }
+
+        if ((number_ != number::None || literal_) && continueScalar(c))
+            continue;
+
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+            continue;
+
+        if (ended_)
+            throw error("unexpected data after the end of the document");
+
+        if (!started_) {
+            if (c != '{')
+                throw error("GeoJSON must be an object");
+            started_ = true;
+            containers_.push_back('{');
+            continue;
+        }
+
+        switch (expect_) {
+        case expect::FirstKey:
+        case expect::Key:
+            if (c == '"') {
+                inString_    = true;
+                stringIsKey_ = true;
+                // Keys of the outermost object are kept to recognize the features.
+                capturing_ = containers_.size() == 1;
+            } else if (c == '}' && expect_ == expect::FirstKey) {
+                close(c);
+            } else {
+                fail("expected a member name");
+            }
+            break;
+        case expect::Colon:
+            if (c != ':')
+                fail("expected ':' after a member name");
+            expect_ = expect::Value;
+            break;
+        case expect::FirstValue:
+            if (c == ']') {
+                close(c);
+                break;
+            }
+            scanValue(c);
+            break;
+        case expect::Value:
+            scanValue(c);
+            break;
+        case expect::Next:
+            if (c == ',') {
+                expect_ = containers_.back() == '{' ? expect::Key : expect::Value;
+            } else if (c == '}' || c == ']') {
+                close(c);
+            } else {
+                fail(containers_.back() == '{' ? "expected ',' or '}'" : "expected ',' or ']'");
+            }
+            break;
+        }
+    }
+}
+
+void features_scanner::scanValue(char c) {
+    if (inFeatures_ && containers_.size() == 2) {
+        if (c != '{')
+            throw error("FeatureCollection features must be objects");
+        featureStart_ = offset_;
+        featureDepth_ = 1;
+        return;
+    }
+
+    const bool member = containers_.size() == 1;
+    if (member && key_ == "features") {
+        if (sawMember_)
+            throw error("duplicate features member");
+        sawMember_ = true;
+        // Features that can't be known to belong to a FeatureCollection yet are left in the
+        // document, which is then parsed as a whole.
+        if (c == '[' && sawType_ && type_ == "FeatureCollection") {
+            inFeatures_  = true;
+            sawFeatures_ = true;
+        }
+    }
+    // Only the value of the first type member is kept, as parse() only reads that one.
+    bool firstType = false;
+    if (member && key_ == "type") {
+        firstType = !sawType_;
+        sawType_  = true;
+    }
+
+    expect_ = expect::Next;
+    switch (c) {
+    case '"':
+        inString_    = true;
+        stringIsKey_ = false;
+        capturing_   = firstType;
+        break;
+    case '{':
+        containers_.push_back('{');
+        expect_ = expect::FirstKey;
+        break;
+    case '[':
+        containers_.push_back('[');
+        expect_ = expect::FirstValue;
+        break;
+    case 't':
+        literal_ = "rue";
+        break;
+    case 'f':
+        literal_ = "alse";
+        break;
+    case 'n':
+        literal_ = "ull";
+        break;
+    case '-':
+        number_ = number::Minus;
+        break;
+    case '0':
+        number_ = number::Zero;
+        break;
+    default:
+        if (c >= '1' && c <= '9') {
+            number_ = number::Integer;
+        } else {
+            fail("expected a value");
+        }
+        break;
+    }
+}
+
+// Takes the next character of a number or literal, and reports whether it was one. A character
+// that can't follow ends the scalar, which must then be complete.
+bool features_scanner::continueScalar(char c) {
+    if (literal_) {
+        if (*literal_ && c == *literal_) {
+            ++literal_;
+            return true;
+        }
+        if (*literal_ || (c >= 'a' && c <= 'z'))
+            fail("invalid literal");
+        literal_ = nullptr;
+        return false;
+    }
+
+    const bool digit = c >= '0' && c <= '9';
+    switch (number_) {
+    case number::Minus:
+        if (!digit)
+            fail("invalid number");
+        number_ = c == '0' ? number::Zero : number::Integer;
+        return true;
+    case number::Zero:
+    case number::Integer:
+        if (digit && number_ == number::Integer)
+            return true;
+        if (c == '.') {
+            number_ = number::Point;
+            return true;
+        }
+        if (c == 'e' || c == 'E') {
+            number_ = number::Exponent;
+            return true;
+        }
+        break;
+    case number::Point:
+        if (!digit)
+            fail("invalid number");
+        number_ = number::Fraction;
+        return true;
+    case number::Fraction:
+        if (digit)
+            return true;
+        if (c == 'e' || c == 'E') {
+            number_ = number::Exponent;
+            return true;
+        }
+        break;
+    case number::Exponent:
+        if (c == '+' || c == '-') {
+            number_ = number::ExponentSign;
+            return true;
+        }
+        if (!digit)
+            fail("invalid number");
+        number_ = number::ExponentDigits;
+        return true;
+    case number::ExponentSign:
+        if (!digit)
+            fail("invalid number");
+        number_ = number::ExponentDigits;
+        return true;
+    case number::ExponentDigits:
+        if (digit)
+            return true;
+        break;
+    case number::None:
+        break;
+    }
+
+    // A complete number may only be followed by a delimiter.
+    if (digit || c == '.' || c == '+' || c == '-' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+        fail("invalid number");
+    number_ = number::None;
+    return false;
+}
+
+// Captured strings are only compared with short names, so longer ones are cut off.
+void features_scanner::append(char c) {
+    if (capturing_ && token_.size() < 32)
+        token_ += c;
+}
+
+// Adds the code point of a \u escape as UTF-8. Each half of a surrogate pair is encoded on its
+// own, which can't match any of the names compared with.
+void features_scanner::appendCodePoint() {
+    if (codePoint_ < 0x80) {
+        append(char(codePoint_));
+    } else if (codePoint_ < 0x800) {
+        append(char(0xC0 | (codePoint_ >> 6)));
+        append(char(0x80 | (codePoint_ & 0x3F)));
+    } else {
+        append(char(0xE0 | (codePoint_ >> 12)));
+        append(char(0x80 | ((codePoint_ >> 6) & 0x3F)));
+        append(char(0x80 | (codePoint_ & 0x3F)));
+    }
+}
+
+void features_scanner::endString() {
+    if (capturing_) {
+        capturing_ = false;
+        if (stringIsKey_) {
+            key_.swap(token_);
+        } else {
+            type_.swap(token_);
+        }
+        token_.clear();
+    }
+    expect_ = stringIsKey_ ? expect::Colon : expect::Next;
+}
+
+void features_scanner::close(char c) {
+    if ((c == '}') != (containers_.back() == '{'))
+        fail(c == '}' ? "unexpected '}' in array" : "unexpected ']' in object");
+    containers_.pop_back();
+    if (inFeatures_ && containers_.size() == 1)
+        inFeatures_ = false;
+    expect_ = expect::Next;
+    if (containers_.empty())
+        ended_ = true;
+}
+
+void features_scanner::scanFeature(char c, std::vector<range> &features) {
+    switch (c) {
+    case '"':
+        inString_ = true;
+        break;
+    case '{':
+    case '[':
+        ++featureDepth_;
+        break;
+    case '}':
+    case ']':
+        if (--featureDepth_ == 0) {
+            features.push_back({ featureStart_, offset_ + 1 });
+            featureStart_ = std::string::npos;
+            expect_       = expect::Next;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void features_scanner::fail(const char *message) const {
+    std::stringstream text;
+    text << message << " at offset " << offset_;
+    throw error(text.str());
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <mapbox/geojson_impl.hpp>
+#include <mapbox/geojson_writer_impl.hpp>
+#include <mapbox/geojson/shared.hpp>
+
+namespace mapbox {
+namespace geojson {
+
+shared_feature::shared_feature()
+    : geometry_(mapbox::geojson::geometry{}), properties_(property_map{}) {
+}
+
+shared_feature::shared_feature(feature &&element)
+    : geometry_(std::move(element.geometry)),
+      properties_(std::move(element.properties)),
+      id_(std::move(element.id)) {
+}
+
+shared_feature::shared_feature(const feature &element)
+    : geometry_(element.geometry), properties_(element.properties), id_(element.id) {
+}
+
+// The owner holds the only reference once the count is 1: other owners could only have been
+// created by copying this object, which the caller isn't allowed to do concurrently. The count
+// is read with acquire ordering, so the reads of owners that have since let go happen before the
+// writes that follow.
+mapbox::geojson::geometry &shared_feature::mutable_geometry() {
+    if (!geometry_.unique()) {
+        geometry_ = shared_detail::shared_block<mapbox::geojson::geometry>(*geometry_);
+    }
+    return *geometry_;
+}
+
+shared_feature::property_map &shared_feature::mutable_properties() {
+    if (!properties_.unique()) {
+        properties_ = shared_detail::shared_block<property_map>(*properties_);
+    }
+    return *properties_;
+}
+
+feature shared_feature::to_feature() const {
+    return feature{ *geometry_, *properties_, id_ };
+}
+
+bool operator==(const shared_feature &lhs, const shared_feature &rhs) {
+    return lhs.id() == rhs.id() &&
+           (lhs.shares_geometry(rhs) || lhs.geometry() == rhs.geometry()) &&
+           (lhs.shares_properties(rhs) || lhs.properties() == rhs.properties());
+}
+
+bool operator!=(const shared_feature &lhs, const shared_feature &rhs) {
+    return !(lhs == rhs);
+}
+
+shared_feature_collection share(feature_collection &&collection) {
+    shared_feature_collection result;
+    result.reserve(collection.size());
+    for (auto &element : collection) {
+        result.emplace_back(std::move(element));
+    }
+    feature_collection().swap(collection);
+    return result;
+}
+
+feature_collection unshare(const shared_feature_collection &collection) {
+    feature_collection result;
+    result.reserve(collection.size());
+    for (const auto &element : collection) {
+        result.push_back(element.to_feature());
+    }
+    return result;
+}
+
+template <>
+shared_feature parse<shared_feature>(const std::string &json) {
+    geojson parsed = parse(json);
+    if (!parsed.is<feature>())
+        throw error("GeoJSON must be a Feature");
+    return shared_feature{ std::move(parsed.get<feature>()) };
+}
+
+template <>
+shared_feature_collection parse<shared_feature_collection>(const std::string &json) {
+    geojson parsed = parse(json);
+    if (!parsed.is<feature_collection>())
+        throw error("GeoJSON must be a FeatureCollection");
+    return share(std::move(parsed.get<feature_collection>()));
+}
+
+template <>
+rapidjson_value convert<shared_feature>(const shared_feature &element, rapidjson_allocator &allocator) {
+    return convertFeature(element.id(), element.geometry(), element.properties(), allocator);
+}
+
+template <>
+rapidjson_value convert<shared_feature_collection>(const shared_feature_collection &collection,
+                                                   rapidjson_allocator &allocator) {
+    rapidjson_value result(rapidjson::kObjectType);
+    result.AddMember("type", "FeatureCollection", allocator);
+
+    rapidjson_value features(rapidjson::kArrayType);
+    for (const auto &element : collection) {
+        features.PushBack(convert(element, allocator), allocator);
+    }
+    result.AddMember("features", features, allocator);
+
+    return result;
+}
+
+// Written directly rather than through a rapidjson document, so the shared blocks are read in
+// place.
+template <>
+std::string stringify<shared_feature>(const shared_feature &element) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    const stringify_options options;
+    geojson_writer<rapidjson::Writer<rapidjson::StringBuffer>>(writer, options).write(element);
+    return buffer.GetString();
+}
+
+template <>
+std::string stringify<shared_feature_collection>(const shared_feature_collection &collection) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    const stringify_options options;
+    geojson_writer<rapidjson::Writer<rapidjson::StringBuffer>>(writer, options).write(collection);
+    return buffer.GetString();
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <mapbox/geojson_impl.hpp>
+#include <mapbox/geojson/tiles.hpp>
+#include <mapbox/geojson_parallel_impl.hpp>
+#include <mapbox/geojson_projection_impl.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace mapbox {
+namespace geojson {
+namespace tile_detail {
+
+constexpr std::uint32_t max_zoom = 24;
+
+// Zoom, x and y packed so that keys sort by zoom, then x, then y.
+inline std::uint64_t tileKey(std::uint32_t z, std::uint32_t x, std::uint32_t y) {
+    return (std::uint64_t(z) << 48) | (std::uint64_t(x) << 24) | y;
+}
+
+// Tiles a box touches at one zoom level, clamped to the Mercator world.
+struct tile_range {
+    std::uint32_t minX;
+    std::uint32_t minY;
+    std::uint32_t maxX;
+    std::uint32_t maxY;
+
+    std::size_t size() const {
+        return std::size_t(maxX - minX + 1) * (maxY - minY + 1);
+    }
+};
+
+inline std::uint32_t clampTile(double tile, std::uint32_t tiles) {
+    return std::uint32_t(std::max(0.0, std::min(double(tiles - 1), std::floor(tile))));
+}
+
+inline double tileY(double latitude, double tiles) {
+    using namespace projection;
+    const double y = std::max(-maxLatitude, std::min(maxLatitude, latitude)) * radians;
+    return (1 - std::log(std::tan(pi / 4 + y / 2)) / pi) / 2 * tiles;
+}
+
+inline tile_range tileRange(const bounding_box &box, std::uint32_t z) {
+    const std::uint32_t tiles = 1u << z;
+    // Tile rows count down from the north.
+    return { clampTile((box.min.x + 180) / 360 * tiles, tiles), clampTile(tileY(box.max.y, tiles), tiles),
+             clampTile((box.max.x + 180) / 360 * tiles, tiles), clampTile(tileY(box.min.y, tiles), tiles) };
+}
+
+// False for boxes of geometries without positions, and ones with NaN coordinates.
+inline bool hasArea(const bounding_box &box) {
+    return box.min.x <= box.max.x && box.min.y <= box.max.y;
+}
+
+} // namespace tile_detail
+
+bounding_box compute_bounding_box(const geometry &shape) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    bounding_box box{ { infinity, infinity }, { -infinity, -infinity } };
+    mapbox::geometry::for_each_point(shape, [&](const point &p) {
+        box.min.x = std::min(box.min.x, p.x);
+        box.min.y = std::min(box.min.y, p.y);
+        box.max.x = std::max(box.max.x, p.x);
+        box.max.y = std::max(box.max.y, p.y);
+    });
+    return box;
+}
+
+tile_index::tile_index(const feature_collection &collection, const tile_index_options &options) {
+    using namespace parallel_detail;
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<bounding_box> boxes(collection.size(),
+                                    bounding_box{ { infinity, infinity }, { -infinity, -infinity } });
+    const auto bounds = splitRuns(collection.size(), options.threads, 1024);
+    parallelFor(bounds.size() - 1, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            boxes[i] = compute_bounding_box(collection[i].geometry);
+        }
+    });
+    build(boxes, options);
+}
+
+tile_index::tile_index(const std::vector<bounding_box> &boxes, const tile_index_options &options) {
+    build(boxes, options);
+}
+
+// Each feature's entries are counted, then written to its own slice of one array, both in
+// parallel. Sorting the entries by tile groups them into the lists, which are then packed.
+void tile_index::build(const std::vector<bounding_box> &boxes, const tile_index_options &options) {
+    using namespace parallel_detail;
+    using namespace tile_detail;
+
+    if (options.min_zoom > options.max_zoom || options.max_zoom > tile_detail::max_zoom)
+        throw error("tile index zoom levels must be ascending and at most 24");
+    if (boxes.size() > std::numeric_limits<std::uint32_t>::max())
+        throw error("too many features for a tile index");
+
+    const std::size_t count = boxes.size();
+    const auto bounds       = splitRuns(count, options.threads, 1024);
+    const std::size_t runs  = bounds.size() - 1;
+
+    std::vector<std::size_t> starts(count + 1, 0);
+    parallelFor(runs, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            std::size_t size = 0;
+            if (hasArea(boxes[i])) {
+                for (std::uint32_t z = options.min_zoom; z <= options.max_zoom; ++z) {
+                    size += tileRange(boxes[i], z).size();
+                }
+            }
+            starts[i + 1] = size;
+        }
+    });
+
+    // Summed with a check, since the sizes of many large boxes can overflow.
+    const std::size_t limit =
+        options.max_entries ? options.max_entries : std::numeric_limits<std::size_t>::max();
+    for (std::size_t i = 1; i <= count; ++i) {
+        if (starts[i] > limit - starts[i - 1]) {
+            std::stringstream message;
+            message << "tile index needs more than the limit of " << limit << " entries";
+            throw limit_error(message.str());
+        }
+        starts[i] += starts[i - 1];
+    }
+    const std::size_t total = starts.back();
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries(total);
+    parallelFor(runs, [&](std::size_t run) {
+        for (std::size_t i = bounds[run]; i < bounds[run + 1]; ++i) {
+            if (!hasArea(boxes[i]))
+                continue;
+            std::size_t next = starts[i];
+            for (std::uint32_t z = options.min_zoom; z <= options.max_zoom; ++z) {
+                const auto range = tileRange(boxes[i], z);
+                for (std::uint32_t x = range.minX; x <= range.maxX; ++x) {
+                    for (std::uint32_t y = range.minY; y <= range.maxY; ++y) {
+                        entries[next++] = { tileKey(z, x, y), std::uint32_t(i) };
+                    }
+                }
+            }
+        }
+    });
+    std::vector<std::size_t>().swap(starts);
+
+    const auto entryBounds = splitRuns(total, options.threads, 4096);
+    parallelFor(entryBounds.size() - 1, [&](std::size_t run) {
+        std::sort(entries.begin() + entryBounds[run], entries.begin() + entryBounds[run + 1]);
+    });
+    mergeRuns(entries, entryBounds);
+
+    std::size_t tileCount = 0;
+    for (std::size_t i = 0; i < total; ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first)
+            ++tileCount;
+    }
+
+    keys_.clear();
+    offsets_.clear();
+    keys_.reserve(tileCount);
+    offsets_.reserve(tileCount + 1);
+    indices_.resize(total);
+    for (std::size_t i = 0; i < total; ++i) {
+        if (i == 0 || entries[i].first != entries[i - 1].first) {
+            keys_.push_back(entries[i].first);
+            offsets_.push_back(i);
+        }
+        indices_[i] = entries[i].second;
+    }
+    offsets_.push_back(total);
+}
+
+tile_features tile_index::features(std::uint32_t z, std::uint32_t x, std::uint32_t y) const {
+    if (z > tile_detail::max_zoom || x >= (1u << z) || y >= (1u << z))
+        return { nullptr, 0 };
+
+    const auto key   = tile_detail::tileKey(z, x, y);
+    const auto found = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (found == keys_.end() || *found != key)
+        return { nullptr, 0 };
+
+    const auto tile = std::size_t(found - keys_.begin());
+    return { indices_.data() + offsets_[tile], offsets_[tile + 1] - offsets_[tile] };
+}
+
+std::size_t tile_index::memory_usage() const {
+    return keys_.capacity() * sizeof(std::uint64_t) + offsets_.capacity() * sizeof(std::size_t) +
+           indices_.capacity() * sizeof(std::uint32_t);
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,832 @@
+#pragma once
+
+#include <mapbox/geojson_impl.hpp>
+#include <mapbox/geojson/topology.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace mapbox {
+namespace geojson {
+namespace topology_detail {
+
+struct point_hash {
+    std::size_t operator()(const point &p) const {
+        // -0.0 equals 0.0, so both must hash the same.
+        const std::size_t x = std::hash<double>()(p.x == 0 ? 0.0 : p.x);
+        const std::size_t y = std::hash<double>()(p.y == 0 ? 0.0 : p.y);
+        return x ^ (y + 0x9e3779b9 + (x << 6) + (x >> 2));
+    }
+};
+
+// Rings shorter than this, or whose ends differ, are cut like lines.
+inline bool isClosedRing(const std::vector<point> &ring) {
+    return ring.size() >= 4 && ring.front() == ring.back();
+}
+
+// Cuts lines and rings into arcs. All lines and rings are recorded first, which finds the
+// junctions: the ends of lines, and positions whose neighbors differ between the lines and rings
+// passing through them, where they meet or part. Each line or ring is then cut at its junctions.
+class topology_builder {
+public:
+    topology build(const feature_collection &collection) {
+        for (const auto &element : collection) {
+            record(element.geometry);
+        }
+
+        result_.features.reserve(collection.size());
+        for (const auto &element : collection) {
+            result_.features.push_back({ convertGeometry(element.geometry), element.properties, element.id });
+        }
+        return std::move(result_);
+    }
+
+private:
+    // The two neighbors of the first line or ring through a position, ordered so that a line and
+    // its reverse agree. Positions marked through operator[] are value-initialized.
+    struct neighbors {
+        point first;
+        point second;
+        bool junction;
+    };
+
+    void mark(const point &p) {
+        positions_[p].junction = true;
+    }
+
+    void visit(const point &p, const point &a, const point &b) {
+        const bool swapped = b.x < a.x || (b.x == a.x && b.y < a.y);
+        const point &first  = swapped ? b : a;
+        const point &second = swapped ? a : b;
+
+        auto found = positions_.find(p);
+        if (found == positions_.end()) {
+            positions_.emplace(p, neighbors{ first, second, false });
+        } else if (!(found->second.first == first && found->second.second == second)) {
+            found->second.junction = true;
+        }
+    }
+
+    bool isJunction(const point &p) const {
+        const auto found = positions_.find(p);
+        return found != positions_.end() && found->second.junction;
+    }
+
+    void recordLine(const std::vector<point> &line) {
+        if (line.empty())
+            return;
+        mark(line.front());
+        mark(line.back());
+        for (std::size_t i = 1; i + 1 < line.size(); ++i) {
+            visit(line[i], line[i - 1], line[i + 1]);
+        }
+    }
+
+    void recordRing(const std::vector<point> &ring) {
+        if (!isClosedRing(ring)) {
+            recordLine(ring);
+            return;
+        }
+        const std::size_t size = ring.size() - 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            visit(ring[i], ring[(i + size - 1) % size], ring[(i + 1) % size]);
+        }
+    }
+
+    // The order lines and rings are recorded in doesn't matter, so collections are walked with
+    // a plain stack of pending geometries.
+    void record(const geometry &root) {
+        std::vector<const geometry *> pending{ &root };
+        while (!pending.empty()) {
+            const geometry &shape = *pending.back();
+            pending.pop_back();
+
+            if (shape.is<line_string>()) {
+                recordLine(shape.get<line_string>());
+            } else if (shape.is<multi_line_string>()) {
+                for (const auto &line : shape.get<multi_line_string>()) {
+                    recordLine(line);
+                }
+            } else if (shape.is<polygon>()) {
+                for (const auto &ring : shape.get<polygon>()) {
+                    recordRing(ring);
+                }
+            } else if (shape.is<multi_polygon>()) {
+                for (const auto &part : shape.get<multi_polygon>()) {
+                    for (const auto &ring : part) {
+                        recordRing(ring);
+                    }
+                }
+            } else if (shape.is<geometry_collection>()) {
+                for (const auto &child : shape.get<geometry_collection>()) {
+                    pending.push_back(&child);
+                }
+            }
+        }
+    }
+
+    static std::size_t hashPositions(const point *begin, const point *end, bool reversed) {
+        std::size_t result = 0;
+        const point_hash hash;
+        for (std::size_t i = 0, size = std::size_t(end - begin); i < size; ++i) {
+            const point &p = reversed ? end[-1 - std::ptrdiff_t(i)] : begin[i];
+            result ^= hash(p) + 0x9e3779b9 + (result << 6) + (result >> 2);
+        }
+        return result;
+    }
+
+    // The index of the arc with these positions, adding it if no arc has them in either
+    // direction. Arcs are found by a hash that is the same for both directions.
+    arc_index arcIndex(const point *begin, const point *end) {
+        const std::size_t size = std::size_t(end - begin);
+        const std::size_t key  = std::min(hashPositions(begin, end, false), hashPositions(begin, end, true));
+
+        const auto candidates = arcsByHash_.equal_range(key);
+        for (auto it = candidates.first; it != candidates.second; ++it) {
+            const auto &arc = result_.arcs[it->second];
+            if (arc.size() != size)
+                continue;
+            if (std::equal(begin, end, arc.begin()))
+                return arc_index(it->second);
+            if (std::equal(begin, end, arc.rbegin()))
+                return ~arc_index(it->second);
+        }
+
+        const std::size_t index = result_.arcs.size();
+        result_.arcs.emplace_back(begin, end);
+        arcsByHash_.emplace(key, index);
+        return arc_index(index);
+    }
+
+    // Cuts at the interior junctions of a line, whose ends are always junctions.
+    arc_path cutLine(const point *begin, const point *end) {
+        arc_path path;
+        const std::size_t size = std::size_t(end - begin);
+        if (size < 2) {
+            if (size == 1)
+                path.push_back(arcIndex(begin, end));
+            return path;
+        }
+
+        std::size_t start = 0;
+        for (std::size_t i = 1; i < size; ++i) {
+            if (i + 1 == size || isJunction(begin[i])) {
+                path.push_back(arcIndex(begin + start, begin + i + 1));
+                start = i;
+            }
+        }
+        return path;
+    }
+
+    // Rings are rotated to start at their first junction and then cut like lines. Rings
+    // without junctions are kept whole, rotated to start at their lowest position so that rings
+    // with the same positions, such as a hole and the island filling it, become the same arc
+    // whichever position they started at.
+    arc_path cutRing(const std::vector<point> &ring) {
+        if (!isClosedRing(ring))
+            return cutLine(ring.data(), ring.data() + ring.size());
+
+        const std::size_t size = ring.size() - 1;
+        std::size_t first = 0;
+        while (first < size && !isJunction(ring[first])) {
+            ++first;
+        }
+        if (first == size) {
+            first = 0;
+            for (std::size_t i = 1; i < size; ++i) {
+                const point &p = ring[i];
+                if (p.x < ring[first].x || (p.x == ring[first].x && p.y < ring[first].y))
+                    first = i;
+            }
+        }
+        if (first == 0)
+            return cutLine(ring.data(), ring.data() + ring.size());
+
+        rotated_.clear();
+        rotated_.insert(rotated_.end(), ring.begin() + first, ring.end() - 1);
+        rotated_.insert(rotated_.end(), ring.begin(), ring.begin() + first + 1);
+        return cutLine(rotated_.data(), rotated_.data() + rotated_.size());
+    }
+
+    topo_geometry convertSimple(const geometry &shape) {
+        topo_geometry result;
+        result.null = false;
+        if (shape.is<point>()) {
+            result.type = geometry_type::Point;
+            result.points.push_back(shape.get<point>());
+        } else if (shape.is<multi_point>()) {
+            const auto &points = shape.get<multi_point>();
+            result.type        = geometry_type::MultiPoint;
+            result.points.assign(points.begin(), points.end());
+        } else if (shape.is<line_string>()) {
+            const auto &line = shape.get<line_string>();
+            result.type      = geometry_type::LineString;
+            result.paths.push_back(cutLine(line.data(), line.data() + line.size()));
+        } else if (shape.is<multi_line_string>()) {
+            result.type = geometry_type::MultiLineString;
+            for (const auto &line : shape.get<multi_line_string>()) {
+                result.paths.push_back(cutLine(line.data(), line.data() + line.size()));
+            }
+        } else if (shape.is<polygon>()) {
+            result.type = geometry_type::Polygon;
+            for (const auto &ring : shape.get<polygon>()) {
+                result.paths.push_back(cutRing(ring));
+            }
+        } else if (shape.is<multi_polygon>()) {
+            result.type = geometry_type::MultiPolygon;
+            for (const auto &part : shape.get<multi_polygon>()) {
+                result.polygon_sizes.push_back(part.size());
+                for (const auto &ring : part) {
+                    result.paths.push_back(cutRing(ring));
+                }
+            }
+        } else {
+            result.null = true;
+        }
+        return result;
+    }
+
+    // Nested collections are converted with an explicit stack, like the GeoJSON conversions.
+    topo_geometry convertGeometry(const geometry &shape) {
+        if (!shape.is<geometry_collection>())
+            return convertSimple(shape);
+
+        struct frame {
+            const geometry_collection *collection;
+            std::size_t next;
+            topo_geometry result;
+        };
+
+        const auto collectionFrame = [](const geometry_collection &collection) {
+            frame added{ &collection, 0, {} };
+            added.result.null = false;
+            added.result.type = geometry_type::GeometryCollection;
+            added.result.geometries.reserve(collection.size());
+            return added;
+        };
+
+        std::vector<frame> stack;
+        stack.push_back(collectionFrame(shape.get<geometry_collection>()));
+        while (true) {
+            auto &top = stack.back();
+            if (top.next == top.collection->size()) {
+                topo_geometry done = std::move(top.result);
+                stack.pop_back();
+                if (stack.empty())
+                    return done;
+                stack.back().result.geometries.push_back(std::move(done));
+                continue;
+            }
+
+            const geometry &child = (*top.collection)[top.next++];
+            if (child.is<geometry_collection>()) {
+                stack.push_back(collectionFrame(child.get<geometry_collection>()));
+            } else {
+                top.result.geometries.push_back(convertSimple(child));
+            }
+        }
+    }
+
+    topology result_;
+    std::unordered_map<point, neighbors, point_hash> positions_;
+    std::unordered_multimap<std::size_t, std::size_t> arcsByHash_;
+    std::vector<point> rotated_;
+};
+
+// Positions of a line or ring, joined from its arcs. Every arc after the first starts at the
+// position the one before it ended on, which is only kept once.
+template <class Line>
+Line joinArcs(const std::vector<line_string> &arcs, const arc_path &path) {
+    Line result;
+    for (const arc_index index : path) {
+        const bool reversed = index < 0;
+        const auto &arc     = arcs[std::size_t(reversed ? ~index : index)];
+        const std::size_t skip = result.empty() || arc.empty() ? 0 : 1;
+        if (reversed) {
+            result.insert(result.end(), arc.rbegin() + skip, arc.rend());
+        } else {
+            result.insert(result.end(), arc.begin() + skip, arc.end());
+        }
+    }
+    return result;
+}
+
+template <class Container>
+Container joinPaths(const std::vector<line_string> &arcs,
+                    std::vector<arc_path>::const_iterator begin,
+                    std::vector<arc_path>::const_iterator end) {
+    Container result;
+    result.reserve(std::size_t(end - begin));
+    for (auto it = begin; it != end; ++it) {
+        result.push_back(joinArcs<typename Container::value_type>(arcs, *it));
+    }
+    return result;
+}
+
+inline geometry toSimpleGeometry(const std::vector<line_string> &arcs, const topo_geometry &shape) {
+    if (shape.null)
+        return geometry{};
+
+    const auto &paths = shape.paths;
+    switch (shape.type) {
+    case geometry_type::Point:
+        return shape.points.front();
+    case geometry_type::MultiPoint:
+        return multi_point(shape.points.begin(), shape.points.end());
+    case geometry_type::LineString:
+        return joinArcs<line_string>(arcs, paths.front());
+    case geometry_type::MultiLineString:
+        return joinPaths<multi_line_string>(arcs, paths.begin(), paths.end());
+    case geometry_type::Polygon:
+        return joinPaths<polygon>(arcs, paths.begin(), paths.end());
+    case geometry_type::MultiPolygon: {
+        multi_polygon result;
+        result.reserve(shape.polygon_sizes.size());
+        auto next = paths.begin();
+        for (const std::size_t size : shape.polygon_sizes) {
+            result.push_back(joinPaths<polygon>(arcs, next, next + std::ptrdiff_t(size)));
+            next += std::ptrdiff_t(size);
+        }
+        return result;
+    }
+    case geometry_type::GeometryCollection:
+        break;
+    }
+    return geometry{};
+}
+
+// Quantized topologies store integer positions, which the transform scales and translates.
+// Arc positions are also delta encoded: each is stored as its offset from the one before.
+struct quantization {
+    bool quantized = false;
+    point scale{ 1, 1 };
+    point translate{ 0, 0 };
+};
+
+inline point readPosition(const rapidjson_value &json) {
+    if (!json.IsArray() || json.Size() < 2 || !json[0].IsNumber() || !json[1].IsNumber())
+        throw error("TopoJSON positions must be arrays of at least two numbers");
+    return { json[0].GetDouble(), json[1].GetDouble() };
+}
+
+inline point readPoint(const rapidjson_value &json, const quantization &transform) {
+    const point p = readPosition(json);
+    if (!transform.quantized)
+        return p;
+    return { p.x * transform.scale.x + transform.translate.x, p.y * transform.scale.y + transform.translate.y };
+}
+
+inline quantization readTransform(const rapidjson_value &json) {
+    quantization result;
+    const auto transform = json.FindMember("transform");
+    if (transform == json.MemberEnd())
+        return result;
+
+    const auto &members = transform->value;
+    if (!members.IsObject())
+        throw error("TopoJSON transform must be an object");
+    const auto scale     = members.FindMember("scale");
+    const auto translate = members.FindMember("translate");
+    if (scale == members.MemberEnd() || translate == members.MemberEnd())
+        throw error("TopoJSON transform must have scale and translate properties");
+
+    result.quantized = true;
+    result.scale     = readPosition(scale->value);
+    result.translate = readPosition(translate->value);
+    return result;
+}
+
+inline std::vector<line_string> readArcs(const rapidjson_value &json, const quantization &transform) {
+    const auto arcs = json.FindMember("arcs");
+    if (arcs == json.MemberEnd() || !arcs->value.IsArray())
+        throw error("Topology must have an arcs array");
+
+    std::vector<line_string> result;
+    result.reserve(arcs->value.Size());
+    for (const auto &arc : arcs->value.GetArray()) {
+        if (!arc.IsArray())
+            throw error("TopoJSON arcs must be arrays of positions");
+
+        line_string positions;
+        positions.reserve(arc.Size());
+        point sum{ 0, 0 };
+        for (const auto &position : arc.GetArray()) {
+            if (!transform.quantized) {
+                positions.push_back(readPosition(position));
+                continue;
+            }
+            const point delta = readPosition(position);
+            sum.x += delta.x;
+            sum.y += delta.y;
+            positions.push_back({ sum.x * transform.scale.x + transform.translate.x,
+                                  sum.y * transform.scale.y + transform.translate.y });
+        }
+        result.push_back(std::move(positions));
+    }
+    return result;
+}
+
+class topology_reader {
+public:
+    topology_reader(std::size_t arcCount, const quantization &transform)
+        : arcCount_(arcCount), transform_(transform) {
+    }
+
+    // Nested collections are converted with an explicit stack, like the GeoJSON conversions.
+    topo_geometry read(const rapidjson_value &json) const {
+        if (!isGeometryCollection(json))
+            return readSimple(json);
+
+        struct frame {
+            const rapidjson_value *geometries;
+            rapidjson::SizeType next;
+            topo_geometry result;
+        };
+
+        const auto collectionFrame = [](const rapidjson_value &members) {
+            frame added{ &members, 0, {} };
+            added.result.null = false;
+            added.result.type = geometry_type::GeometryCollection;
+            added.result.geometries.reserve(members.Size());
+            return added;
+        };
+
+        std::vector<frame> stack;
+        stack.push_back(collectionFrame(geometryCollectionMembers(json)));
+        while (true) {
+            auto &top = stack.back();
+            if (top.next == top.geometries->Size()) {
+                topo_geometry done = std::move(top.result);
+                stack.pop_back();
+                if (stack.empty())
+                    return done;
+                stack.back().result.geometries.push_back(std::move(done));
+                continue;
+            }
+
+            const auto &element = (*top.geometries)[top.next++];
+            if (isGeometryCollection(element)) {
+                stack.push_back(collectionFrame(geometryCollectionMembers(element)));
+            } else {
+                top.result.geometries.push_back(readSimple(element));
+            }
+        }
+    }
+
+private:
+    arc_path readPath(const rapidjson_value &json) const {
+        if (!json.IsArray())
+            throw error("TopoJSON arcs must be arrays of arc indices");
+
+        arc_path result;
+        result.reserve(json.Size());
+        for (const auto &element : json.GetArray()) {
+            if (!element.IsInt64())
+                throw error("TopoJSON arc indices must be integers");
+            const arc_index index = element.GetInt64();
+            if (std::uint64_t(index < 0 ? ~index : index) >= arcCount_)
+                throw error("TopoJSON arc index out of range");
+            result.push_back(index);
+        }
+        return result;
+    }
+
+    void readPaths(const rapidjson_value &json, std::vector<arc_path> &paths) const {
+        if (!json.IsArray())
+            throw error("TopoJSON arcs must be arrays of arc indices");
+        paths.reserve(paths.size() + json.Size());
+        for (const auto &element : json.GetArray()) {
+            paths.push_back(readPath(element));
+        }
+    }
+
+    topo_geometry readSimple(const rapidjson_value &json) const {
+        if (!json.IsObject())
+            throw error("TopoJSON geometry objects must be objects");
+
+        topo_geometry result;
+        const auto type = json.FindMember("type");
+        if (type == json.MemberEnd())
+            throw error("TopoJSON geometry objects must have a type property");
+        if (type->value.IsNull())
+            return result;
+
+        result.null = false;
+        const auto &name = type->value;
+        if (name == "Point" || name == "MultiPoint") {
+            const auto coordinates = json.FindMember("coordinates");
+            if (coordinates == json.MemberEnd() || !coordinates->value.IsArray())
+                throw error(std::string(name.GetString()) + " geometry must have a coordinates array");
+            if (name == "Point") {
+                result.type = geometry_type::Point;
+                result.points.push_back(readPoint(coordinates->value, transform_));
+            } else {
+                result.type = geometry_type::MultiPoint;
+                for (const auto &position : coordinates->value.GetArray()) {
+                    result.points.push_back(readPoint(position, transform_));
+                }
+            }
+            return result;
+        }
+
+        if (!name.IsString())
+            throw error("TopoJSON geometry type must be a string");
+        const auto arcs = json.FindMember("arcs");
+        if (arcs == json.MemberEnd() || !arcs->value.IsArray())
+            throw error(std::string(name.GetString()) + " geometry must have an arcs array");
+
+        if (name == "LineString") {
+            result.type = geometry_type::LineString;
+            result.paths.push_back(readPath(arcs->value));
+        } else if (name == "MultiLineString" || name == "Polygon") {
+            result.type = name == "Polygon" ? geometry_type::Polygon : geometry_type::MultiLineString;
+            readPaths(arcs->value, result.paths);
+        } else if (name == "MultiPolygon") {
+            result.type = geometry_type::MultiPolygon;
+            for (const auto &part : arcs->value.GetArray()) {
+                const std::size_t before = result.paths.size();
+                readPaths(part, result.paths);
+                result.polygon_sizes.push_back(result.paths.size() - before);
+            }
+        } else {
+            throw error(std::string(name.GetString()) + " not yet implemented");
+        }
+        return result;
+    }
+
+    std::size_t arcCount_;
+    quantization transform_;
+};
+
+inline topo_feature readFeature(const topology_reader &reader, const rapidjson_value &json) {
+    topo_feature result{ reader.read(json), {}, {} };
+
+    const auto id = json.FindMember("id");
+    if (id != json.MemberEnd())
+        result.id = convert<identifier>(id->value);
+
+    const auto properties = json.FindMember("properties");
+    if (properties != json.MemberEnd() && !properties->value.IsNull())
+        result.properties = convert<prop_map>(properties->value);
+    return result;
+}
+
+inline rapidjson_value writePositions(const std::vector<point> &positions, rapidjson_allocator &allocator) {
+    rapidjson_value result(rapidjson::kArrayType);
+    result.Reserve(rapidjson::SizeType(positions.size()), allocator);
+    for (const auto &p : positions) {
+        rapidjson_value position(rapidjson::kArrayType);
+        position.PushBack(p.x, allocator).PushBack(p.y, allocator);
+        result.PushBack(position, allocator);
+    }
+    return result;
+}
+
+inline rapidjson_value writePath(const arc_path &path, rapidjson_allocator &allocator) {
+    rapidjson_value result(rapidjson::kArrayType);
+    result.Reserve(rapidjson::SizeType(path.size()), allocator);
+    for (const arc_index index : path) {
+        result.PushBack(index, allocator);
+    }
+    return result;
+}
+
+inline rapidjson_value writePaths(std::vector<arc_path>::const_iterator begin,
+                                  std::vector<arc_path>::const_iterator end,
+                                  rapidjson_allocator &allocator) {
+    rapidjson_value result(rapidjson::kArrayType);
+    for (auto it = begin; it != end; ++it) {
+        result.PushBack(writePath(*it, allocator), allocator);
+    }
+    return result;
+}
+
+inline rapidjson_value writeSimple(const topo_geometry &shape, rapidjson_allocator &allocator) {
+    rapidjson_value result(rapidjson::kObjectType);
+    if (shape.null) {
+        rapidjson_value null(rapidjson::kNullType);
+        result.AddMember("type", null, allocator);
+        return result;
+    }
+
+    const auto &paths = shape.paths;
+    switch (shape.type) {
+    case geometry_type::Point: {
+        result.AddMember("type", "Point", allocator);
+        rapidjson_value position(rapidjson::kArrayType);
+        position.PushBack(shape.points.front().x, allocator).PushBack(shape.points.front().y, allocator);
+        result.AddMember("coordinates", position, allocator);
+        break;
+    }
+    case geometry_type::MultiPoint:
+        result.AddMember("type", "MultiPoint", allocator);
+        result.AddMember("coordinates", writePositions(shape.points, allocator), allocator);
+        break;
+    case geometry_type::LineString:
+        result.AddMember("type", "LineString", allocator);
+        result.AddMember("arcs", writePath(paths.front(), allocator), allocator);
+        break;
+    case geometry_type::MultiLineString:
+        result.AddMember("type", "MultiLineString", allocator);
+        result.AddMember("arcs", writePaths(paths.begin(), paths.end(), allocator), allocator);
+        break;
+    case geometry_type::Polygon:
+        result.AddMember("type", "Polygon", allocator);
+        result.AddMember("arcs", writePaths(paths.begin(), paths.end(), allocator), allocator);
+        break;
+    case geometry_type::MultiPolygon: {
+        result.AddMember("type", "MultiPolygon", allocator);
+        rapidjson_value parts(rapidjson::kArrayType);
+        auto next = paths.begin();
+        for (const std::size_t size : shape.polygon_sizes) {
+            parts.PushBack(writePaths(next, next + std::ptrdiff_t(size), allocator), allocator);
+            next += std::ptrdiff_t(size);
+        }
+        result.AddMember("arcs", parts, allocator);
+        break;
+    }
+    case geometry_type::GeometryCollection:
+        break;
+    }
+    return result;
+}
+
+// Nested collections are written with an explicit stack, like the GeoJSON conversions.
+inline rapidjson_value writeGeometry(const topo_geometry &shape, rapidjson_allocator &allocator) {
+    if (shape.null || shape.type != geometry_type::GeometryCollection)
+        return writeSimple(shape, allocator);
+
+    struct frame {
+        const topo_geometry *collection;
+        std::size_t next;
+        rapidjson_value geometries;
+    };
+
+    const auto finish = [&](rapidjson_value &geometries) {
+        rapidjson_value result(rapidjson::kObjectType);
+        result.AddMember("type", "GeometryCollection", allocator);
+        result.AddMember("geometries", geometries, allocator);
+        return result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &shape, 0, rapidjson_value(rapidjson::kArrayType) });
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.collection->geometries.size()) {
+            rapidjson_value done = finish(top.geometries);
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+            stack.back().geometries.PushBack(done, allocator);
+            continue;
+        }
+
+        const topo_geometry &child = top.collection->geometries[top.next++];
+        if (!child.null && child.type == geometry_type::GeometryCollection) {
+            stack.push_back({ &child, 0, rapidjson_value(rapidjson::kArrayType) });
+        } else {
+            top.geometries.PushBack(writeSimple(child, allocator), allocator);
+        }
+    }
+}
+
+} // namespace topology_detail
+
+// Nested collections are rebuilt with an explicit stack, like the conversions.
+mapbox::geojson::geometry topology::to_geometry(const topo_geometry &shape) const {
+    using topology_detail::toSimpleGeometry;
+    if (shape.null || shape.type != geometry_type::GeometryCollection)
+        return toSimpleGeometry(arcs, shape);
+
+    struct frame {
+        const topo_geometry *collection;
+        std::size_t next;
+        geometry_collection result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &shape, 0, {} });
+    stack.back().result.reserve(shape.geometries.size());
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.collection->geometries.size()) {
+            geometry_collection done = std::move(top.result);
+            stack.pop_back();
+            if (stack.empty())
+                return done;
+            stack.back().result.emplace_back(std::move(done));
+            continue;
+        }
+
+        const topo_geometry &child = top.collection->geometries[top.next++];
+        if (!child.null && child.type == geometry_type::GeometryCollection) {
+            stack.push_back({ &child, 0, {} });
+            stack.back().result.reserve(child.geometries.size());
+        } else {
+            top.result.push_back(toSimpleGeometry(arcs, child));
+        }
+    }
+}
+
+feature topology::to_feature(std::size_t index) const {
+    const auto &element = features[index];
+    feature result{ to_geometry(element.geometry) };
+    result.properties = element.properties;
+    result.id         = element.id;
+    return result;
+}
+
+feature_collection topology::to_feature_collection() const {
+    feature_collection result;
+    result.reserve(features.size());
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        result.push_back(to_feature(i));
+    }
+    return result;
+}
+
+topology to_topology(const feature_collection &collection) {
+    return topology_detail::topology_builder().build(collection);
+}
+
+topology parse_topology(const std::string &json) {
+    using namespace topology_detail;
+
+    rapidjson_document d;
+    d.Parse<rapidjson::kParseIterativeFlag>(json.c_str());
+    if (d.HasParseError()) {
+        std::stringstream message;
+        message << d.GetErrorOffset() << " - " << rapidjson::GetParseError_En(d.GetParseError());
+        throw error(message.str());
+    }
+
+    if (!d.IsObject())
+        throw error("Topology must be an object");
+    const auto type = d.FindMember("type");
+    if (type == d.MemberEnd() || type->value != "Topology")
+        throw error("Topology type must be Topology");
+    const auto objects = d.FindMember("objects");
+    if (objects == d.MemberEnd() || !objects->value.IsObject())
+        throw error("Topology must have an objects object");
+
+    const quantization transform = readTransform(d);
+    topology result;
+    result.arcs = readArcs(d, transform);
+
+    const topology_reader reader(result.arcs.size(), transform);
+    for (const auto &object : objects->value.GetObject()) {
+        if (isGeometryCollection(object.value)) {
+            for (const auto &member : geometryCollectionMembers(object.value).GetArray()) {
+                result.features.push_back(readFeature(reader, member));
+            }
+        } else {
+            result.features.push_back(readFeature(reader, object.value));
+        }
+    }
+    return result;
+}
+
+std::string stringify_topology(const topology &element) {
+    using namespace topology_detail;
+
+    rapidjson_allocator allocator;
+    rapidjson_value geometries(rapidjson::kArrayType);
+    geometries.Reserve(rapidjson::SizeType(element.features.size()), allocator);
+    for (const auto &member : element.features) {
+        rapidjson_value object = writeGeometry(member.geometry, allocator);
+        if (!member.id.is<null_value_t>())
+            object.AddMember("id", identifier::visit(member.id, to_value{ allocator }), allocator);
+        if (!member.properties.empty())
+            object.AddMember("properties", to_value{ allocator }(member.properties), allocator);
+        geometries.PushBack(object, allocator);
+    }
+
+    rapidjson_value features(rapidjson::kObjectType);
+    features.AddMember("type", "GeometryCollection", allocator);
+    features.AddMember("geometries", geometries, allocator);
+    rapidjson_value objects(rapidjson::kObjectType);
+    objects.AddMember("features", features, allocator);
+
+    rapidjson_value arcs(rapidjson::kArrayType);
+    arcs.Reserve(rapidjson::SizeType(element.arcs.size()), allocator);
+    for (const auto &arc : element.arcs) {
+        arcs.PushBack(writePositions(arc, allocator), allocator);
+    }
+
+    rapidjson_value result(rapidjson::kObjectType);
+    result.AddMember("type", "Topology", allocator);
+    result.AddMember("objects", objects, allocator);
+    result.AddMember("arcs", arcs, allocator);
+
+    rapidjson::GenericStringBuffer<rapidjson::UTF8<>, rapidjson_allocator> buffer;
+    rapidjson::Writer<decltype(buffer)> writer(buffer);
+    result.Accept(writer);
+    return buffer.GetString();
+}
+
+} // namespace geojson
+} // namespace mapbox
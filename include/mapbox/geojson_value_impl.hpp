@@ -3,6 +3,8 @@
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/value.hpp>
 
+#include <vector>
+
 namespace mapbox {
 namespace geojson {
 
@@ -55,6 +57,68 @@ Container convert(const value &val) {
     return points;
 }
 
+template <>
+geometry convert<geometry>(const value &val);
+
+bool isGeometryCollection(const value &val) {
+    const auto *valueObject = val.getObject();
+    if (!valueObject) {
+        return false;
+    }
+    const auto typeIt = valueObject->find("type");
+    return typeIt != valueObject->end() && typeIt->second.is<std::string>() &&
+           *typeIt->second.getString() == "GeometryCollection";
+}
+
+const value::array_type &geometryCollectionMembers(const value::object_type &valueObject) {
+    auto geometriesIt = valueObject.find("geometries");
+    if (geometriesIt == valueObject.end()) {
+        throw error("GeometryCollection must have a geometries property");
+    }
+
+    const auto *geometryArray = geometriesIt->second.getArray();
+    if (!geometryArray) {
+        throw error("GeometryCollection geometries property must be an array");
+    }
+    return *geometryArray;
+}
+
+// Nested collections are converted with an explicit stack rather than by recursing, so the
+// depth of the input doesn't bound the depth of the call stack.
+geometry_collection convertGeometryCollection(const value::array_type &geometryArray) {
+    struct frame {
+        const value::array_type *geometries;
+        std::size_t next;
+        geometry_collection result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &geometryArray, 0, {} });
+    stack.back().result.reserve(geometryArray.size());
+
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.geometries->size()) {
+            geometry_collection done = std::move(top.result);
+            stack.pop_back();
+            if (stack.empty()) {
+                return done;
+            }
+            stack.back().result.emplace_back(std::move(done));
+            continue;
+        }
+
+        const auto &element = (*top.geometries)[top.next++];
+        if (isGeometryCollection(element)) {
+            const auto &members = geometryCollectionMembers(*element.getObject());
+            stack.push_back({ &members, 0, {} });
+            stack.back().result.reserve(members.size());
+        } else {
+            top.result.push_back(convert<geometry>(element));
+        }
+    }
+}
+
 template <>
 geometry convert<geometry>(const value &val) {
     auto *valueObject = val.getObject();
@@ -75,17 +139,7 @@ geometry convert<geometry>(const value &val) {
     const auto &typeString = *typeValue.getString();
 
     if (typeString == "GeometryCollection") {
-        auto geometriesIt = valueObject->find("geometries");
-        if (geometriesIt == valueObject->end()) {
-            throw error("GeometryCollection must have a geometries property");
-        }
-
-        const auto *geometryArray = geometriesIt->second.getArray();
-        if (!geometryArray) {
-            throw error("GeometryCollection geometries property must be an array");
-        }
-
-        return geometry{ convert<geometry_collection>(*geometryArray) };
+        return geometry{ convertGeometryCollection(geometryCollectionMembers(*valueObject)) };
     }
 
     auto coordinatesIt = valueObject->find("coordinates");
@@ -221,81 +275,137 @@ geojson convert(const value &val) {
         [](const auto &) -> geojson { throw error("Invalid GeoJSON value was provided."); });
 }
 
-value convert(const point &p) {
-    return value::array_type{ p.x, p.y };
+value::array_type toCoordinates(const point &p) {
+    return { p.x, p.y };
 }
 
 template <typename Cont>
-value convert(const Cont &points) {
+value::array_type toCoordinates(const Cont &points) {
     value::array_type result;
     result.reserve(points.size());
     for (const auto &p : points) {
-        result.emplace_back(convert(p));
+        // Construct each element in place: moving a value that holds an array or object
+        // reallocates its recursive wrapper.
+        result.emplace_back(toCoordinates(p));
     }
     return result;
 }
 
-value convert(const geometry &geom) {
+// Builds a GeoJSON object holding a type and one member. Members are emplaced rather than taken
+// from an initializer list, which would deep-copy the coordinates.
+value::object_type toTypedObject(const char *type, const char *key, value::array_type &&members) {
+    value::object_type result;
+    result.reserve(2);
+    result.emplace("type", type);
+    result.emplace(key, std::move(members));
+    return result;
+}
+
+value::object_type toObject(const geometry &geom);
+
+// Nested collections are converted with an explicit stack rather than by recursing, so the
+// depth of the input doesn't bound the depth of the call stack.
+value::array_type toGeometries(const geometry_collection &gc) {
+    struct frame {
+        const geometry_collection *geometries;
+        std::size_t next;
+        value::array_type result;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ &gc, 0, {} });
+    stack.back().result.reserve(gc.size());
+
+    while (true) {
+        auto &top = stack.back();
+        if (top.next == top.geometries->size()) {
+            value::array_type done = std::move(top.result);
+            stack.pop_back();
+            if (stack.empty()) {
+                return done;
+            }
+            stack.back().result.emplace_back(
+                toTypedObject("GeometryCollection", "geometries", std::move(done)));
+            continue;
+        }
+
+        const auto &gcGeom = (*top.geometries)[top.next++];
+        if (gcGeom.is<empty>()) {
+            top.result.emplace_back();
+        } else if (gcGeom.is<geometry_collection>()) {
+            const auto &members = gcGeom.get<geometry_collection>();
+            stack.push_back({ &members, 0, {} });
+            stack.back().result.reserve(members.size());
+        } else {
+            top.result.emplace_back(toObject(gcGeom));
+        }
+    }
+}
+
+value::object_type toObject(const geometry &geom) {
     return geom.match(
-        [](const empty &) { return value{}; },
-        [](const point &p) {
-            return value::object_type{ { "type", "Point" }, { "coordinates", convert(p) } };
-        },
+        [](const empty &) -> value::object_type { throw error("Empty geometry is not an object"); },
+        [](const point &p) { return toTypedObject("Point", "coordinates", toCoordinates(p)); },
         [](const multi_point &mp) {
-            return value::object_type{ { "type", "MultiPoint" }, { "coordinates", convert(mp) } };
+            return toTypedObject("MultiPoint", "coordinates", toCoordinates(mp));
         },
         [](const line_string &ls) {
-            return value::object_type{ { "type", "LineString" }, { "coordinates", convert(ls) } };
+            return toTypedObject("LineString", "coordinates", toCoordinates(ls));
         },
         [](const multi_line_string &mls) {
-            return value::object_type{ { "type", "MultiLineString" },
-                                       { "coordinates", convert(mls) } };
+            return toTypedObject("MultiLineString", "coordinates", toCoordinates(mls));
         },
         [](const polygon &pol) {
-            return value::object_type{ { "type", "Polygon" }, { "coordinates", convert(pol) } };
+            return toTypedObject("Polygon", "coordinates", toCoordinates(pol));
         },
         [](const multi_polygon &mpol) {
-            return value::object_type{ { "type", "MultiPolygon" },
-                                       { "coordinates", convert(mpol) } };
+            return toTypedObject("MultiPolygon", "coordinates", toCoordinates(mpol));
         },
         [](const geometry_collection &gc) {
-            value::array_type geometries;
-            geometries.reserve(gc.size());
-            for (const auto &gcGeom : gc) {
-                geometries.push_back(convert(gcGeom));
-            }
-            return value::object_type{ { "type", "GeometryCollection" },
-                                       { "geometries", std::move(geometries) } };
+            return toTypedObject("GeometryCollection", "geometries", toGeometries(gc));
         });
 }
 
-value convert(const feature &f) {
-    value::object_type result{
-        { "type", "Feature" },
-        { "geometry", convert(f.geometry) },
-        { "properties", f.properties }
-    };
+value::object_type toObject(const feature &f) {
+    value::object_type result;
+    result.reserve(4);
+    result.emplace("type", "Feature");
+    if (f.geometry.is<empty>()) {
+        result.emplace("geometry", value{});
+    } else {
+        result.emplace("geometry", toObject(f.geometry));
+    }
+    result.emplace("properties", f.properties);
 
     if (!f.id.is<mapbox::geojson::null_value_t>()) {
         value id = f.id.match(
             [](uint64_t n) -> value { return n; }, [](int64_t n) -> value { return n; },
             [](double n) -> value { return n; }, [](std::string s) -> value { return s; },
             [](const auto &) -> value { throw error("Unknown type for a Feature 'id'"); });
-        result.emplace(std::make_pair("id", std::move(id)));
+        result.emplace("id", std::move(id));
     }
 
     return result;
 }
 
+value convert(const geometry &geom) {
+    if (geom.is<empty>()) {
+        return value{};
+    }
+    return toObject(geom);
+}
+
+value convert(const feature &f) {
+    return toObject(f);
+}
+
 value convert(const feature_collection &collection) {
-    value::object_type result{ { "type", "FeatureCollection" } };
     value::array_type features;
     features.reserve(collection.size());
     for (const auto &feat : collection) {
-        features.emplace_back(convert(feat));
+        features.emplace_back(toObject(feat));
     }
-    result.emplace(std::make_pair("features", std::move(features)));
-    return result;
+    return toTypedObject("FeatureCollection", "features", std::move(features));
 }
 
 value convert(const geojson &json) {
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <mapbox/geojson_impl.hpp>
+#include <mapbox/geojson/view.hpp>
+
+namespace mapbox {
+namespace geojson {
+namespace view {
+
+template <typename T>
+void validate(const rapidjson_value &json);
+
+template <>
+void validate<point>(const rapidjson_value &json) {
+    if (!json.IsArray()) {
+        throw error("coordinates must be an array.");
+    }
+    if (json.Size() < 2)
+        throw error("coordinates array must have at least 2 numbers");
+    if (!json[0].IsNumber() || !json[1].IsNumber())
+        throw error("coordinates must be numbers");
+}
+
+template <typename Cont>
+void validate(const rapidjson_value &json) {
+    if (!json.IsArray()) {
+        throw error("coordinates must be an array of points describing linestring or an array of "
+                    "arrays describing polygons and line strings.");
+    }
+    for (auto &element : json.GetArray()) {
+        validate<typename Cont::value_type>(element);
+    }
+}
+
+// Builds the view for a geometry object. The input is checked only when check is set; views
+// nested in a collection are rebuilt on every access and were already checked when the
+// outermost view was created.
+geometry toGeometry(const rapidjson_value &json, bool check) {
+    if (json.IsNull())
+        return empty{};
+
+    if (check && !json.IsObject())
+        throw error("Geometry must be an object");
+
+    const auto &json_end = json.MemberEnd();
+
+    const auto &type_itr = json.FindMember("type");
+    if (check && type_itr == json_end)
+        throw error("Geometry must have a type property");
+
+    const auto &type = type_itr->value;
+
+    if (type == "GeometryCollection") {
+        const auto &geometries_itr = json.FindMember("geometries");
+        if (check) {
+            if (geometries_itr == json_end)
+                throw error("GeometryCollection must have a geometries property");
+            if (!geometries_itr->value.IsArray())
+                throw error("GeometryCollection geometries property must be an array");
+            for (auto &element : geometries_itr->value.GetArray()) {
+                toGeometry(element, true);
+            }
+        }
+        return geometry_collection(geometries_itr->value);
+    }
+
+    const auto &coords_itr = json.FindMember("coordinates");
+
+    if (check && coords_itr == json_end)
+        throw error(std::string(type.GetString()) + " geometry must have a coordinates property");
+
+    const auto &json_coords = coords_itr->value;
+    if (check && !json_coords.IsArray())
+        throw error("coordinates property must be an array");
+
+    if (type == "Point") {
+        if (check)
+            validate<point>(json_coords);
+        return element<point>::make(json_coords);
+    }
+    if (type == "MultiPoint") {
+        if (check)
+            validate<multi_point>(json_coords);
+        return multi_point(json_coords);
+    }
+    if (type == "LineString") {
+        if (check) {
+            validate<line_string>(json_coords);
+            validateLineString(json_coords);
+        }
+        return line_string(json_coords);
+    }
+    if (type == "MultiLineString") {
+        if (check) {
+            validate<multi_line_string>(json_coords);
+            for (auto &element : json_coords.GetArray()) {
+                validateLineString(element);
+            }
+        }
+        return multi_line_string(json_coords);
+    }
+    if (type == "Polygon") {
+        if (check) {
+            validatePolygon(json_coords);
+            validate<polygon>(json_coords);
+        }
+        return polygon(json_coords);
+    }
+    if (type == "MultiPolygon") {
+        if (check) {
+            for (auto &element : json_coords.GetArray()) {
+                validatePolygon(element);
+            }
+            validate<multi_polygon>(json_coords);
+        }
+        return multi_polygon(json_coords);
+    }
+    throw error(std::string(type.GetString()) + " not yet implemented");
+}
+
+feature toFeature(const rapidjson_value &json, bool check) {
+    if (check && !json.IsObject())
+        throw error("Feature must be an object");
+
+    auto const &json_end = json.MemberEnd();
+
+    if (check) {
+        auto const &type_itr = json.FindMember("type");
+        if (type_itr == json_end)
+            throw error("Feature must have a type property");
+        if (type_itr->value != "Feature")
+            throw error("Feature type must be Feature");
+    }
+
+    auto const &geom_itr = json.FindMember("geometry");
+
+    if (check && geom_itr == json_end)
+        throw error("Feature must have a geometry property");
+
+    feature result{ toGeometry(geom_itr->value, check), {}, {} };
+
+    auto const &id_itr = json.FindMember("id");
+    if (id_itr != json_end) {
+        result.id = mapbox::geojson::convert<identifier>(id_itr->value);
+    }
+
+    auto const &prop_itr = json.FindMember("properties");
+    if (prop_itr != json_end) {
+        const auto &json_props = prop_itr->value;
+        if (!json_props.IsNull()) {
+            if (check && !json_props.IsObject())
+                throw error("properties must be an object");
+            result.properties = property_map(json_props);
+        }
+    }
+
+    return result;
+}
+
+geometry element<geometry>::make(const rapidjson_value &json) {
+    return toGeometry(json, false);
+}
+
+feature element<feature>::make(const rapidjson_value &json) {
+    return toFeature(json, false);
+}
+
+} // namespace view
+
+template <>
+view::geometry convert<view::geometry>(const rapidjson_value &json) {
+    return view::toGeometry(json, true);
+}
+
+template <>
+view::feature convert<view::feature>(const rapidjson_value &json) {
+    return view::toFeature(json, true);
+}
+
+template <>
+view::feature_collection convert<view::feature_collection>(const rapidjson_value &json) {
+    if (!json.IsObject())
+        throw error("FeatureCollection must be an object");
+
+    const auto &json_end = json.MemberEnd();
+
+    const auto &type_itr = json.FindMember("type");
+    if (type_itr == json_end || type_itr->value != "FeatureCollection")
+        throw error("FeatureCollection type must be FeatureCollection");
+
+    const auto &features_itr = json.FindMember("features");
+    if (features_itr == json_end)
+        throw error("FeatureCollection must have features property");
+
+    const auto &json_features = features_itr->value;
+
+    if (!json_features.IsArray())
+        throw error("FeatureCollection features property must be an array");
+
+    for (auto &feature_obj : json_features.GetArray()) {
+        view::toFeature(feature_obj, true);
+    }
+
+    return view::feature_collection(json_features);
+}
+
+template <>
+view::geojson convert<view::geojson>(const rapidjson_value &json) {
+    if (!json.IsObject())
+        throw error("GeoJSON must be an object");
+
+    const auto &type_itr = json.FindMember("type");
+
+    if (type_itr == json.MemberEnd())
+        throw error("GeoJSON must have a type property");
+
+    const auto &type = type_itr->value;
+
+    if (type == "FeatureCollection")
+        return view::geojson{ convert<view::feature_collection>(json) };
+
+    if (type == "Feature")
+        return view::geojson{ view::toFeature(json, true) };
+
+    return view::geojson{ view::toGeometry(json, true) };
+}
+
+} // namespace geojson
+} // namespace mapbox
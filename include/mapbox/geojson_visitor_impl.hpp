@@ -0,0 +1,863 @@
+#pragma once
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/visitor.hpp>
+#include <mapbox/geojson_number_impl.hpp>
+
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/error/en.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+using error = std::runtime_error;
+
+const char *toString(geometry_type type) {
+    switch (type) {
+    case geometry_type::Point:
+        return "Point";
+    case geometry_type::LineString:
+        return "LineString";
+    case geometry_type::Polygon:
+        return "Polygon";
+    case geometry_type::MultiPoint:
+        return "MultiPoint";
+    case geometry_type::MultiLineString:
+        return "MultiLineString";
+    case geometry_type::MultiPolygon:
+        return "MultiPolygon";
+    case geometry_type::GeometryCollection:
+        return "GeometryCollection";
+    }
+    abort();
+}
+
+bool toGeometryType(const std::string &name, geometry_type &type) {
+    for (auto candidate : { geometry_type::Point, geometry_type::LineString,
+                            geometry_type::Polygon, geometry_type::MultiPoint,
+                            geometry_type::MultiLineString, geometry_type::MultiPolygon,
+                            geometry_type::GeometryCollection }) {
+        if (name == toString(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Validates the arrays nested in a "coordinates" member and reports them to a visitor.
+class coordinates_reader {
+public:
+    coordinates_reader(visitor &v, geometry_type type, bool checked)
+        : visitor_(&v), type_(type), checked_(checked) {
+        switch (type) {
+        case geometry_type::Point:
+            leaf_ = 1;
+            break;
+        case geometry_type::MultiPoint:
+        case geometry_type::LineString:
+            leaf_ = 2;
+            break;
+        case geometry_type::Polygon:
+        case geometry_type::MultiLineString:
+            leaf_ = 3;
+            break;
+        default:
+            leaf_ = 4;
+            break;
+        }
+    }
+
+    // Nesting depth of the array being read; zero once the outermost array has ended.
+    std::size_t depth() const {
+        return depth_;
+    }
+
+    void begin() {
+        if (++depth_ > leaf_) {
+            throw error("coordinates are nested too deeply");
+        }
+        if (depth_ == leaf_) {
+            numbers_ = 0;
+            return;
+        }
+        switch (type_) {
+        case geometry_type::LineString:
+            if (depth_ == 1)
+                beginLineString();
+            break;
+        case geometry_type::MultiLineString:
+            if (depth_ == 2)
+                beginLineString();
+            break;
+        case geometry_type::Polygon:
+            if (depth_ == 2)
+                beginRing();
+            break;
+        case geometry_type::MultiPolygon:
+            if (depth_ == 2)
+                visitor_->begin_polygon();
+            if (depth_ == 3)
+                beginRing();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void end() {
+        if (depth_ == leaf_) {
+            if (checked_ && numbers_ < 2) {
+                throw error("coordinates array must have at least 2 numbers");
+            }
+            visitor_->position(x_, y_);
+            ++positions_;
+        } else {
+            switch (type_) {
+            case geometry_type::LineString:
+                if (depth_ == 1)
+                    endLineString();
+                break;
+            case geometry_type::MultiLineString:
+                if (depth_ == 2)
+                    endLineString();
+                break;
+            case geometry_type::Polygon:
+                if (depth_ == 2)
+                    endRing();
+                break;
+            case geometry_type::MultiPolygon:
+                if (depth_ == 3)
+                    endRing();
+                if (depth_ == 2)
+                    visitor_->end_polygon();
+                break;
+            default:
+                break;
+            }
+        }
+        --depth_;
+    }
+
+    void number(double n) {
+        if (depth_ < leaf_) {
+            throw error("coordinates must be nested arrays ending in positions");
+        }
+        // Coordinates beyond the second (altitude, measures) are ignored.
+        if (++numbers_ == 1) {
+            x_ = n;
+        } else if (numbers_ == 2) {
+            y_ = n;
+        }
+    }
+
+private:
+    void beginLineString() {
+        positions_ = 0;
+        visitor_->begin_line_string();
+    }
+
+    void endLineString() {
+        if (checked_ && positions_ < 2) {
+            throw error("A line string must have two or more coordinate points.");
+        }
+        visitor_->end_line_string();
+    }
+
+    void beginRing() {
+        positions_ = 0;
+        visitor_->begin_ring();
+    }
+
+    void endRing() {
+        if (checked_ && positions_ < 4) {
+            throw error("Polygon must be described by 4 or more coordinate points. Improper "
+                        "nesting can also lead to this error. Double check that the coordinates "
+                        "are properly nested and there are 4 or more coordinates.");
+        }
+        visitor_->end_ring();
+    }
+
+    visitor *visitor_;
+    geometry_type type_;
+    bool checked_;
+    std::size_t leaf_;
+    std::size_t depth_     = 0;
+    std::size_t numbers_   = 0;
+    std::size_t positions_ = 0;
+    double x_              = 0;
+    double y_              = 0;
+};
+
+// rapidjson SAX handler that tracks where it is in the GeoJSON structure and forwards content
+// to a visitor. Property values are the only content assembled in memory.
+class visitor_reader {
+public:
+    visitor_reader(visitor &v, const parse_options &options)
+        : visitor_(v),
+          numbers_(options.full_precision),
+          checked_(!options.trusted),
+          limits_(effective(options.limits)) {
+    }
+
+    bool Null() {
+        scalar(value{});
+        return true;
+    }
+
+    bool Bool(bool b) {
+        scalar(value{ b });
+        return true;
+    }
+
+    bool Int(int i) {
+        return Int64(i);
+    }
+
+    bool Uint(unsigned u) {
+        return Uint64(u);
+    }
+
+    bool Int64(std::int64_t i) {
+        if (i >= 0)
+            return Uint64(std::uint64_t(i));
+        number(double(i), value{ i });
+        return true;
+    }
+
+    bool Uint64(std::uint64_t u) {
+        number(double(u), value{ u });
+        return true;
+    }
+
+    bool Double(double d) {
+        number(d, value{ d });
+        return true;
+    }
+
+    // Numbers arrive as text so coordinates can use number_parser. Integers outside coordinates
+    // keep their integer type, as with the other number events.
+    bool RawNumber(const char *str, rapidjson::SizeType length, bool) {
+        if (frames_.empty() || frames_.back() != frame::coordinates) {
+            std::uint64_t magnitude;
+            if (*str == '-' && parseUnsigned(str + 1, length - 1, magnitude) &&
+                magnitude <= std::uint64_t(INT64_MAX) + 1) {
+                return Int64(magnitude == std::uint64_t(INT64_MAX) + 1 ? INT64_MIN
+                                                                      : -std::int64_t(magnitude));
+            }
+            if (parseUnsigned(str, length, magnitude)) {
+                return Uint64(magnitude);
+            }
+        }
+        return Double(numbers_.parse(str, length));
+    }
+
+    bool String(const char *str, rapidjson::SizeType length, bool) {
+        checkString(length);
+        scalar(value{ std::string(str, length) });
+        return true;
+    }
+
+    bool StartObject() {
+        start(true);
+        return true;
+    }
+
+    bool Key(const char *str, rapidjson::SizeType length, bool) {
+        checkString(length);
+        key(str, length);
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        end();
+        return true;
+    }
+
+    bool StartArray() {
+        start(false);
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        end();
+        return true;
+    }
+
+private:
+    enum class frame { object, features, geometries, coordinates, properties, array_value, object_value, skip };
+    enum class object_kind { Unknown, FeatureCollection, Feature, Geometry };
+    enum class member_kind { none, type, features, feature_geometry, properties, id, coordinates, geometries, other };
+
+    struct coordinate_token {
+        enum { open, close, coordinate } kind;
+        double number;
+    };
+
+    struct object_state {
+        object_kind kind        = object_kind::Unknown;
+        member_kind member      = member_kind::none;
+        geometry_type type      = geometry_type::Point;
+        bool has_type           = false;
+        bool has_features       = false;
+        bool has_geometry       = false;
+        bool has_coordinates    = false;
+        bool has_geometries     = false;
+        bool begun              = false;
+        // Coordinates read before the geometry type was known.
+        std::vector<coordinate_token> buffered;
+    };
+
+    static bool equals(const char *str, rapidjson::SizeType length, const char *name) {
+        return std::strlen(name) == length && std::memcmp(str, name, length) == 0;
+    }
+
+    // Members that belong to a different kind of object than the one being read are foreign
+    // members and get skipped.
+    static member_kind classify(const object_state &object, const char *str, rapidjson::SizeType length) {
+        member_kind member = member_kind::other;
+        object_kind owner  = object_kind::Unknown;
+        if (equals(str, length, "type")) {
+            return member_kind::type;
+        } else if (equals(str, length, "features")) {
+            member = member_kind::features;
+            owner  = object_kind::FeatureCollection;
+        } else if (equals(str, length, "geometry")) {
+            member = member_kind::feature_geometry;
+            owner  = object_kind::Feature;
+        } else if (equals(str, length, "properties")) {
+            member = member_kind::properties;
+            owner  = object_kind::Feature;
+        } else if (equals(str, length, "id")) {
+            member = member_kind::id;
+            owner  = object_kind::Feature;
+        } else if (equals(str, length, "coordinates")) {
+            member = member_kind::coordinates;
+            owner  = object_kind::Geometry;
+        } else if (equals(str, length, "geometries")) {
+            member = member_kind::geometries;
+            owner  = object_kind::Geometry;
+        } else {
+            return member_kind::other;
+        }
+
+        if (object.kind != object_kind::Unknown && object.kind != owner)
+            return member_kind::other;
+        if (object.kind == object_kind::Geometry && (object.has_type || object.begun)) {
+            const bool collection = object.type == geometry_type::GeometryCollection;
+            if (member == member_kind::coordinates && collection)
+                return member_kind::other;
+            if (member == member_kind::geometries && !collection)
+                return member_kind::other;
+        }
+        return member;
+    }
+
+    static std::size_t effective(std::size_t limit) {
+        return limit ? limit : std::numeric_limits<std::size_t>::max();
+    }
+
+    static parse_limits effective(parse_limits limits) {
+        limits.max_input_bytes          = effective(limits.max_input_bytes);
+        limits.max_depth                = effective(limits.max_depth);
+        limits.max_geometry_coordinates = effective(limits.max_geometry_coordinates);
+        limits.max_feature_coordinates  = effective(limits.max_feature_coordinates);
+        limits.max_document_coordinates = effective(limits.max_document_coordinates);
+        limits.max_properties           = effective(limits.max_properties);
+        limits.max_string_length        = effective(limits.max_string_length);
+        return limits;
+    }
+
+    [[noreturn]] static void exceeded(const char *what, std::size_t limit, const char *unit) {
+        std::stringstream message;
+        message << what << " exceeds the limit of " << limit << " " << unit;
+        throw limit_error(message.str());
+    }
+
+    void checkString(std::size_t length) {
+        if (length > limits_.max_string_length)
+            exceeded("string", limits_.max_string_length, "characters");
+    }
+
+    void countCoordinate() {
+        ++coordinateCount_;
+        if (coordinateCount_ - geometryStart_ > limits_.max_geometry_coordinates)
+            exceeded("geometry", limits_.max_geometry_coordinates, "coordinates");
+        if (inFeature_ && coordinateCount_ - featureStart_ > limits_.max_feature_coordinates)
+            exceeded("feature", limits_.max_feature_coordinates, "coordinates");
+        if (coordinateCount_ > limits_.max_document_coordinates)
+            exceeded("document", limits_.max_document_coordinates, "coordinates");
+    }
+
+    void beginFeature() {
+        inFeature_     = true;
+        featureStart_  = coordinateCount_;
+        propertyCount_ = 0;
+        visitor_.begin_feature();
+    }
+
+    void pushObject(object_kind kind) {
+        objects_.emplace_back();
+        objects_.back().kind = kind;
+        frames_.push_back(frame::object);
+        if (kind == object_kind::Feature) {
+            beginFeature();
+        }
+    }
+
+    void implyKind(object_state &object, object_kind kind) {
+        if (object.kind != object_kind::Unknown)
+            return;
+        object.kind = kind;
+        if (kind == object_kind::FeatureCollection) {
+            visitor_.begin_feature_collection();
+        } else if (kind == object_kind::Feature) {
+            beginFeature();
+        }
+    }
+
+    void beginGeometry(object_state &object) {
+        if (!object.begun) {
+            object.begun = true;
+            visitor_.begin_geometry(object.type);
+        }
+    }
+
+    void setType(object_state &object, const std::string &type) {
+        if (object.has_type)
+            return;
+        object.has_type = true;
+
+        switch (object.kind) {
+        case object_kind::Unknown:
+            if (type == "FeatureCollection") {
+                implyKind(object, object_kind::FeatureCollection);
+                return;
+            }
+            if (type == "Feature") {
+                implyKind(object, object_kind::Feature);
+                return;
+            }
+            object.kind = object_kind::Geometry;
+            break;
+        case object_kind::FeatureCollection:
+            if (type != "FeatureCollection")
+                throw error("FeatureCollection type must be FeatureCollection");
+            return;
+        case object_kind::Feature:
+            if (type != "Feature")
+                throw error("Feature type must be Feature");
+            return;
+        case object_kind::Geometry:
+            break;
+        }
+
+        geometry_type parsed;
+        if (!toGeometryType(type, parsed))
+            throw error(type + " not yet implemented");
+        if (object.begun && parsed != object.type)
+            throw error(type + " geometry must not have a geometries property");
+        object.type = parsed;
+
+        if (object.has_coordinates && parsed == geometry_type::GeometryCollection) {
+            object.has_coordinates = false;
+        } else if (object.has_coordinates) {
+            beginGeometry(object);
+            coordinates_reader reader(visitor_, parsed, checked_);
+            for (const auto &token : object.buffered) {
+                if (token.kind == coordinate_token::open) {
+                    reader.begin();
+                } else if (token.kind == coordinate_token::close) {
+                    reader.end();
+                } else {
+                    reader.number(token.number);
+                }
+            }
+        }
+        std::vector<coordinate_token>().swap(object.buffered);
+    }
+
+    static identifier toIdentifier(const value &id) {
+        return id.match([](const std::string &string) -> identifier { return { string }; },
+                        [](int64_t number) -> identifier { return { number }; },
+                        [](uint64_t number) -> identifier { return { number }; },
+                        [](double number) -> identifier { return { number }; },
+                        [](const auto &) -> identifier {
+                            throw error("Feature id must be a string or number");
+                        });
+    }
+
+    void key(const char *str, rapidjson::SizeType length) {
+        switch (frames_.back()) {
+        case frame::object:
+            objects_.back().member = classify(objects_.back(), str, length);
+            break;
+        case frame::properties:
+            if (++propertyCount_ > limits_.max_properties)
+                exceeded("feature", limits_.max_properties, "properties");
+            key_.assign(str, length);
+            break;
+        case frame::object_value:
+            keys_.back().assign(str, length);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void number(double n, value &&v) {
+        if (!frames_.empty() && frames_.back() == frame::coordinates) {
+            countCoordinate();
+            if (buffering_) {
+                objects_.back().buffered.push_back({ coordinate_token::coordinate, n });
+            } else {
+                coordinates_.number(n);
+            }
+            return;
+        }
+        scalar(std::move(v));
+    }
+
+    void scalar(value &&v) {
+        if (frames_.empty())
+            throw error("GeoJSON must be an object");
+
+        switch (frames_.back()) {
+        case frame::object:
+            memberScalar(objects_.back(), std::move(v));
+            return;
+        case frame::features:
+            throw error("Feature must be an object");
+        case frame::geometries:
+            if (!v.is<null_value_t>())
+                throw error("Geometry must be an object");
+            return;
+        case frame::coordinates:
+            throw error("coordinates must be numbers");
+        case frame::properties:
+            visitor_.property(std::move(key_), std::move(v));
+            return;
+        case frame::array_value:
+            values_.back().get<value::array_type>().push_back(std::move(v));
+            return;
+        case frame::object_value:
+            values_.back().get<value::object_type>().emplace(std::move(keys_.back()), std::move(v));
+            return;
+        case frame::skip:
+            return;
+        }
+    }
+
+    void memberScalar(object_state &object, value &&v) {
+        switch (object.member) {
+        case member_kind::type:
+            if (!v.is<std::string>())
+                throw error("type property must be a string");
+            setType(object, v.get<std::string>());
+            return;
+        case member_kind::features:
+            throw error("FeatureCollection features property must be an array");
+        case member_kind::feature_geometry:
+            if (!v.is<null_value_t>())
+                throw error("Geometry must be an object");
+            implyKind(object, object_kind::Feature);
+            object.has_geometry = true;
+            return;
+        case member_kind::properties:
+            if (!v.is<null_value_t>())
+                throw error("properties must be an object");
+            implyKind(object, object_kind::Feature);
+            visitor_.end_properties();
+            return;
+        case member_kind::id:
+            implyKind(object, object_kind::Feature);
+            visitor_.feature_id(toIdentifier(v));
+            return;
+        case member_kind::coordinates:
+            throw error("coordinates property must be an array");
+        case member_kind::geometries:
+            throw error("GeometryCollection geometries property must be an array");
+        default:
+            return;
+        }
+    }
+
+    void start(bool isObject) {
+        if (++depth_ > limits_.max_depth)
+            exceeded("nesting", limits_.max_depth, "levels");
+
+        if (frames_.empty()) {
+            if (!isObject)
+                throw error("GeoJSON must be an object");
+            pushObject(object_kind::Unknown);
+            return;
+        }
+
+        switch (frames_.back()) {
+        case frame::object:
+            startMember(objects_.back(), isObject);
+            return;
+        case frame::features:
+            if (!isObject)
+                throw error("Feature must be an object");
+            pushObject(object_kind::Feature);
+            return;
+        case frame::geometries:
+            if (!isObject)
+                throw error("Geometry must be an object");
+            pushObject(object_kind::Geometry);
+            return;
+        case frame::coordinates:
+            if (isObject)
+                throw error("coordinates must be numbers");
+            if (buffering_) {
+                objects_.back().buffered.push_back({ coordinate_token::open, 0 });
+                ++bufferDepth_;
+            } else {
+                coordinates_.begin();
+            }
+            return;
+        case frame::properties:
+        case frame::array_value:
+        case frame::object_value:
+            frames_.push_back(isObject ? frame::object_value : frame::array_value);
+            if (isObject) {
+                values_.emplace_back(value::object_type{});
+                keys_.emplace_back();
+            } else {
+                values_.emplace_back(value::array_type{});
+            }
+            return;
+        case frame::skip:
+            ++skipDepth_;
+            return;
+        }
+    }
+
+    void startMember(object_state &object, bool isObject) {
+        switch (object.member) {
+        case member_kind::type:
+            throw error("type property must be a string");
+        case member_kind::features:
+            if (isObject)
+                throw error("FeatureCollection features property must be an array");
+            implyKind(object, object_kind::FeatureCollection);
+            object.has_features = true;
+            frames_.push_back(frame::features);
+            return;
+        case member_kind::feature_geometry:
+            if (!isObject)
+                throw error("Geometry must be an object");
+            implyKind(object, object_kind::Feature);
+            object.has_geometry = true;
+            pushObject(object_kind::Geometry);
+            return;
+        case member_kind::properties:
+            if (!isObject)
+                throw error("properties must be an object");
+            implyKind(object, object_kind::Feature);
+            frames_.push_back(frame::properties);
+            return;
+        case member_kind::id:
+            throw error("Feature id must be a string or number");
+        case member_kind::coordinates:
+            if (isObject)
+                throw error("coordinates property must be an array");
+            implyKind(object, object_kind::Geometry);
+            frames_.push_back(frame::coordinates);
+            geometryStart_ = coordinateCount_;
+            buffering_ = !object.has_type;
+            if (buffering_) {
+                object.buffered.push_back({ coordinate_token::open, 0 });
+                bufferDepth_ = 1;
+            } else {
+                beginGeometry(object);
+                coordinates_ = coordinates_reader(visitor_, object.type, checked_);
+                coordinates_.begin();
+            }
+            return;
+        case member_kind::geometries:
+            if (isObject)
+                throw error("GeometryCollection geometries property must be an array");
+            implyKind(object, object_kind::Geometry);
+            object.type           = geometry_type::GeometryCollection;
+            object.has_geometries = true;
+            beginGeometry(object);
+            frames_.push_back(frame::geometries);
+            return;
+        default:
+            frames_.push_back(frame::skip);
+            skipDepth_ = 1;
+            return;
+        }
+    }
+
+    void end() {
+        --depth_;
+        switch (frames_.back()) {
+        case frame::object:
+            endObject(objects_.back());
+            objects_.pop_back();
+            frames_.pop_back();
+            return;
+        case frame::coordinates:
+            if (buffering_) {
+                objects_.back().buffered.push_back({ coordinate_token::close, 0 });
+                if (--bufferDepth_ == 0) {
+                    objects_.back().has_coordinates = true;
+                    frames_.pop_back();
+                }
+            } else {
+                coordinates_.end();
+                if (coordinates_.depth() == 0) {
+                    objects_.back().has_coordinates = true;
+                    frames_.pop_back();
+                }
+            }
+            return;
+        case frame::array_value:
+        case frame::object_value: {
+            if (frames_.back() == frame::object_value)
+                keys_.pop_back();
+            value complete = std::move(values_.back());
+            values_.pop_back();
+            frames_.pop_back();
+            scalar(std::move(complete));
+            return;
+        }
+        case frame::skip:
+            if (--skipDepth_ == 0)
+                frames_.pop_back();
+            return;
+        case frame::properties:
+            frames_.pop_back();
+            visitor_.end_properties();
+            return;
+        default:
+            frames_.pop_back();
+            return;
+        }
+    }
+
+    void endObject(object_state &object) {
+        switch (object.kind) {
+        case object_kind::Unknown:
+            throw error("GeoJSON must have a type property");
+        case object_kind::FeatureCollection:
+            if (checked_ && !object.has_type)
+                throw error("GeoJSON must have a type property");
+            if (checked_ && !object.has_features)
+                throw error("FeatureCollection must have features property");
+            visitor_.end_feature_collection();
+            return;
+        case object_kind::Feature:
+            if (checked_ && !object.has_type)
+                throw error("Feature must have a type property");
+            if (checked_ && !object.has_geometry)
+                throw error("Feature must have a geometry property");
+            inFeature_ = false;
+            visitor_.end_feature();
+            return;
+        case object_kind::Geometry:
+            if (!object.has_type)
+                throw error("Geometry must have a type property");
+            if (object.type == geometry_type::GeometryCollection) {
+                if (!object.has_geometries)
+                    throw error("GeometryCollection must have a geometries property");
+            } else if (!object.has_coordinates) {
+                throw error(std::string(toString(object.type)) +
+                            " geometry must have a coordinates property");
+            }
+            visitor_.end_geometry(object.type);
+            return;
+        }
+    }
+
+    visitor &visitor_;
+    const number_parser numbers_;
+    const bool checked_;
+    const parse_limits limits_;
+    std::size_t depth_           = 0;
+    std::size_t coordinateCount_ = 0;
+    std::size_t geometryStart_   = 0;
+    std::size_t featureStart_    = 0;
+    std::size_t propertyCount_   = 0;
+    bool inFeature_              = false;
+    std::vector<frame> frames_;
+    std::vector<object_state> objects_;
+    coordinates_reader coordinates_{ visitor_, geometry_type::Point, checked_ };
+    bool buffering_          = false;
+    std::size_t bufferDepth_ = 0;
+    std::size_t skipDepth_   = 0;
+    // Property values under construction, and the pending key of each object among them.
+    std::string key_;
+    std::vector<value> values_;
+    std::vector<std::string> keys_;
+};
+
+// Reads from any rapidjson input stream; the caller checks the input size. A reader kept between
+// calls reuses its stack.
+template <class Stream>
+void parseStream(rapidjson::Reader &reader, Stream &stream, visitor &v, const parse_options &options) {
+    visitor_reader handler(v, options);
+    reader.Parse<rapidjson::kParseIterativeFlag | rapidjson::kParseNumbersAsStringsFlag>(stream, handler);
+    if (reader.HasParseError()) {
+        std::stringstream message;
+        message << reader.GetErrorOffset() << " - "
+                << rapidjson::GetParseError_En(reader.GetParseErrorCode());
+        throw error(message.str());
+    }
+}
+
+template <class Stream>
+void parseStream(Stream &stream, visitor &v, const parse_options &options) {
+    rapidjson::Reader reader;
+    parseStream(reader, stream, v, options);
+}
+
+void checkInputSize(std::size_t size, const parse_options &options) {
+    if (options.limits.max_input_bytes && size > options.limits.max_input_bytes) {
+        std::stringstream message;
+        message << "input exceeds the limit of " << options.limits.max_input_bytes << " bytes";
+        throw limit_error(message.str());
+    }
+}
+
+void parseEvents(rapidjson::Reader &reader,
+                 const std::string &json,
+                 visitor &v,
+                 const parse_options &options) {
+    checkInputSize(json.size(), options);
+    rapidjson::StringStream stream(json.c_str());
+    parseStream(reader, stream, v, options);
+}
+
+// For text that isn't null terminated, such as part of a larger buffer.
+void parseEvents(rapidjson::Reader &reader,
+                 const char *json,
+                 std::size_t size,
+                 visitor &v,
+                 const parse_options &options) {
+    checkInputSize(size, options);
+    rapidjson::MemoryStream stream(json, size);
+    parseStream(reader, stream, v, options);
+}
+
+void parseEvents(const std::string &json, visitor &v, const parse_options &options) {
+    rapidjson::Reader reader;
+    parseEvents(reader, json, v, options);
+}
+
+void parse(const std::string &json, visitor &v) {
+    parseEvents(json, v, parse_options{});
+}
+
+} // namespace geojson
+} // namespace mapbox
@@ -0,0 +1,325 @@
+#pragma once
+
+#include <mapbox/geojson_impl.hpp>
+#include <mapbox/geojson_hilbert_impl.hpp>
+#include <mapbox/geojson/shared.hpp>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace mapbox {
+namespace geojson {
+
+// Writes GeoJSON straight to a rapidjson writer, without building a document first. The output
+// matches stringify(); coordinates go through the transform on the way.
+template <class Writer>
+class geojson_writer {
+public:
+    geojson_writer(Writer &writer, const stringify_options &options)
+        : writer_(writer), options_(options) {
+    }
+
+    // Nested collections are written with an explicit stack rather than by recursing, so the
+    // depth of the input doesn't bound the depth of the call stack.
+    void write(const geometry &element) {
+        struct frame {
+            const geometry_collection *geometries;
+            std::size_t next;
+        };
+
+        std::vector<frame> stack;
+        const geometry *next = &element;
+        while (next) {
+            const geometry &current = *next;
+            next                    = nullptr;
+
+            if (current.is<empty>()) {
+                writer_.Null();
+            } else {
+                writer_.StartObject();
+                writer_.Key("type");
+                writer_.String(geometry::visit(current, to_type()));
+                if (current.is<geometry_collection>()) {
+                    writer_.Key("geometries");
+                    writer_.StartArray();
+                    stack.push_back({ &current.get<geometry_collection>(), 0 });
+                } else {
+                    writer_.Key("coordinates");
+                    geometry::visit(
+                        current, [&](const auto &alternative) { writeCoordinates(alternative); });
+                    writer_.EndObject();
+                }
+            }
+
+            // Moves on to the next geometry, closing the collections that are done.
+            while (!next && !stack.empty()) {
+                auto &top = stack.back();
+                if (top.next < top.geometries->size()) {
+                    next = &(*top.geometries)[top.next++];
+                } else {
+                    writer_.EndArray();
+                    writer_.EndObject();
+                    stack.pop_back();
+                }
+            }
+        }
+    }
+
+    void write(const feature &element) {
+        writeFeature(element.id, element.geometry, element.properties);
+    }
+
+    void write(const shared_feature &element) {
+        writeFeature(element.id(), element.geometry(), element.properties());
+    }
+
+    // Handles feature_collection and shared_feature_collection.
+    template <class Feature>
+    void write(const std::vector<Feature> &collection) {
+        writer_.StartObject();
+        writer_.Key("type");
+        writer_.String("FeatureCollection");
+        writer_.Key("features");
+        writer_.StartArray();
+        if (options_.spatial_order) {
+            const auto order = hilbert_detail::order(
+                collection.size(),
+                [&](std::size_t i) -> const geometry & { return geometryOf(collection[i]); }, 0);
+            for (std::size_t i : order) {
+                write(collection[i]);
+            }
+        } else {
+            for (const auto &element : collection) {
+                write(element);
+            }
+        }
+        writer_.EndArray();
+        writer_.EndObject();
+    }
+
+private:
+    static const geometry &geometryOf(const feature &element) {
+        return element.geometry;
+    }
+    static const geometry &geometryOf(const shared_feature &element) {
+        return element.geometry();
+    }
+
+    void writeFeature(const identifier &id, const geometry &shape, const value::object_type &properties) {
+        writer_.StartObject();
+        writer_.Key("type");
+        writer_.String("Feature");
+        if (!id.is<null_value_t>()) {
+            writer_.Key("id");
+            identifier::visit(id, [&](const auto &alternative) { writeValue(alternative); });
+        }
+        writer_.Key("geometry");
+        write(shape);
+        writer_.Key("properties");
+        writeValue(properties);
+        writer_.EndObject();
+    }
+
+    void writeRun() {
+        if (options_.transform) {
+            options_.transform(points_.data(), points_.size());
+        }
+    }
+
+    void writePosition(const point &p) {
+        writer_.StartArray();
+        writeCoordinate(p.x);
+        writeCoordinate(p.y);
+        writer_.EndArray();
+    }
+
+    // Formats coordinates rounded to a fixed number of decimal places from a scaled integer.
+    // Values too large to scale, and non-finite ones, are left to the writer.
+    void writeCoordinate(double n) {
+        static constexpr double scales[] = { 1e0, 1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+                                             1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17 };
+        int places = options_.decimal_places;
+        if (places < 0 || places > 17) {
+            writer_.Double(n);
+            return;
+        }
+
+        const double scaled = std::round(n * scales[places]);
+        if (!(std::abs(scaled) < 9e18)) {
+            writer_.Double(n);
+            return;
+        }
+
+        const bool negative  = scaled < 0;
+        std::uint64_t digits = std::uint64_t(negative ? -scaled : scaled);
+        while (places > 0 && digits % 10 == 0) {
+            digits /= 10;
+            --places;
+        }
+
+        char buffer[32];
+        char *const end = buffer + sizeof(buffer);
+        char *p         = end;
+        for (; places > 0; --places) {
+            *--p = char('0' + digits % 10);
+            digits /= 10;
+        }
+        if (p != end) {
+            *--p = '.';
+        }
+        do {
+            *--p = char('0' + digits % 10);
+            digits /= 10;
+        } while (digits);
+        if (negative) {
+            *--p = '-';
+        }
+        writer_.RawValue(p, std::size_t(end - p), rapidjson::kNumberType);
+    }
+
+    void writeCoordinates(const point &p) {
+        points_.assign(1, p);
+        writeRun();
+        writePosition(points_.front());
+    }
+
+    // Handles multi_point, line_string and linear_ring.
+    void writeCoordinates(const std::vector<point> &positions) {
+        points_.assign(positions.begin(), positions.end());
+        writeRun();
+        writer_.StartArray();
+        for (const auto &p : points_) {
+            writePosition(p);
+        }
+        writer_.EndArray();
+    }
+
+    // Handles polygon, multi_line_string and multi_polygon.
+    template <class E>
+    void writeCoordinates(const std::vector<E> &parts) {
+        writer_.StartArray();
+        for (const auto &part : parts) {
+            writeCoordinates(part);
+        }
+        writer_.EndArray();
+    }
+
+    void writeCoordinates(const empty &) {
+        abort();
+    }
+
+    void writeCoordinates(const geometry_collection &) {
+        abort();
+    }
+
+    void writeValue(null_value_t) {
+        writer_.Null();
+    }
+
+    void writeValue(bool t) {
+        writer_.Bool(t);
+    }
+
+    void writeValue(int64_t t) {
+        writer_.Int64(t);
+    }
+
+    void writeValue(uint64_t t) {
+        writer_.Uint64(t);
+    }
+
+    void writeValue(double t) {
+        writer_.Double(t);
+    }
+
+    void writeValue(const std::string &t) {
+        writer_.String(t.data(), rapidjson::SizeType(t.size()));
+    }
+
+    void writeValue(const std::vector<value> &array) {
+        writeNested(&array, nullptr);
+    }
+
+    void writeValue(const std::unordered_map<std::string, value> &map) {
+        writeNested(nullptr, &map);
+    }
+
+    // An array or object being written, and the element it is up to.
+    struct container {
+        const std::vector<value> *array;
+        const std::unordered_map<std::string, value> *object;
+        std::vector<value>::const_iterator nextItem;
+        std::unordered_map<std::string, value>::const_iterator nextMember;
+    };
+
+    container open(const std::vector<value> *array,
+                   const std::unordered_map<std::string, value> *object) {
+        container result{ array, object, {}, {} };
+        if (array) {
+            writer_.StartArray();
+            result.nextItem = array->begin();
+        } else {
+            writer_.StartObject();
+            result.nextMember = object->begin();
+        }
+        return result;
+    }
+
+    // Arrays and objects are written with an explicit stack rather than by recursing, so the
+    // nesting depth of the input doesn't bound the depth of the call stack.
+    void writeNested(const std::vector<value> *array,
+                     const std::unordered_map<std::string, value> *object) {
+        std::vector<container> stack;
+        stack.push_back(open(array, object));
+
+        while (!stack.empty()) {
+            auto &top            = stack.back();
+            const value *element = nullptr;
+            if (top.array) {
+                if (top.nextItem == top.array->end()) {
+                    writer_.EndArray();
+                    stack.pop_back();
+                    continue;
+                }
+                element = &*top.nextItem++;
+            } else {
+                if (top.nextMember == top.object->end()) {
+                    writer_.EndObject();
+                    stack.pop_back();
+                    continue;
+                }
+                const auto &key = top.nextMember->first;
+                writer_.Key(key.data(), rapidjson::SizeType(key.size()));
+                element = &top.nextMember++->second;
+            }
+
+            if (element->is<value::array_type>()) {
+                stack.push_back(open(&element->get<value::array_type>(), nullptr));
+            } else if (element->is<value::object_type>()) {
+                stack.push_back(open(nullptr, &element->get<value::object_type>()));
+            } else {
+                value::visit(*element, [&](const auto &alternative) { writeValue(alternative); });
+            }
+        }
+    }
+
+    Writer &writer_;
+    const stringify_options &options_;
+    std::vector<point> points_;
+};
+
+std::string stringify(const geojson &element, const stringify_options &options) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    geojson_writer<rapidjson::Writer<rapidjson::StringBuffer>> out(writer, options);
+    geojson::visit(element, [&](const auto &alternative) { out.write(alternative); });
+    return buffer.GetString();
+}
+
+} // namespace geojson
+} // namespace mapbox
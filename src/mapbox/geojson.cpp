@@ -1,2 +1,30 @@
 #include <mapbox/geojson_impl.hpp>
 #include <mapbox/geojson_value_impl.hpp>
+#include <mapbox/geojson_view_impl.hpp>
+#include <mapbox/geojson_visitor_impl.hpp>
+#include <mapbox/geojson_builder_impl.hpp>
+#include <mapbox/geojson_hilbert_impl.hpp>
+#include <mapbox/geojson_writer_impl.hpp>
+#include <mapbox/geojson_projection_impl.hpp>
+#include <mapbox/geojson_memory_impl.hpp>
+#include <mapbox/geojson_frozen_impl.hpp>
+#include <mapbox/geojson_shared_impl.hpp>
+#include <mapbox/geojson_scanner_impl.hpp>
+#include <mapbox/geojson_push_parser_impl.hpp>
+#include <mapbox/geojson_tiles_impl.hpp>
+#include <mapbox/geojson_topology_impl.hpp>
+#include <mapbox/geojson_columns_impl.hpp>
+#include <mapbox/geojson_filter_impl.hpp>
+#include <mapbox/geojson_id_index_impl.hpp>
+
+// Optional components, compiled in when their macro is defined to 1. Gzip needs zlib, the batch
+// parser and ingest run threads, and ingest maps files with POSIX calls.
+#if MAPBOX_GEOJSON_GZIP
+#include <mapbox/geojson_gzip_impl.hpp>
+#endif
+#if MAPBOX_GEOJSON_BATCH
+#include <mapbox/geojson_batch_impl.hpp>
+#endif
+#if MAPBOX_GEOJSON_INGEST
+#include <mapbox/geojson_ingest_impl.hpp>
+#endif
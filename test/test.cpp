@@ -1,14 +1,41 @@
 #include <mapbox/geojson.hpp>
+#include <mapbox/geojson/batch.hpp>
+#include <mapbox/geojson/columns.hpp>
+#include <mapbox/geojson/count_allocations.hpp>
+#include <mapbox/geojson/filter.hpp>
+#include <mapbox/geojson/frozen.hpp>
+#include <mapbox/geojson/gzip.hpp>
+#include <mapbox/geojson/hilbert.hpp>
+#include <mapbox/geojson/id_index.hpp>
+#include <mapbox/geojson/ingest.hpp>
+#include <mapbox/geojson/instrumentation.hpp>
+#include <mapbox/geojson/memory.hpp>
+#include <mapbox/geojson/push_parser.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
+#include <mapbox/geojson/shared.hpp>
+#include <mapbox/geojson/tiles.hpp>
+#include <mapbox/geojson/topology.hpp>
+#include <mapbox/geojson/projection.hpp>
+#include <mapbox/geojson/view.hpp>
+#include <mapbox/geojson/visitor.hpp>
 #include <mapbox/geometry.hpp>
+#include <mapbox/geometry/envelope.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
 
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 
 using namespace mapbox::geojson;
 
@@ -26,6 +53,13 @@ geojson readGeoJSON(const std::string &path, bool use_convert) {
     }
 }
 
+static void readDocument(const std::string &path, rapidjson_document &d) {
+    std::ifstream t(path.c_str());
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    d.Parse<0>(buffer.str().c_str());
+}
+
 template <class T>
 std::string writeGeoJSON(const T& t, bool use_convert) {
     if (use_convert) {
@@ -292,6 +326,1545 @@ static void testParseErrorHandling() {
     }
 }
 
+static void testView() {
+    for (const auto &path : { "test/fixtures/point.json",
+                              "test/fixtures/multi-point.json",
+                              "test/fixtures/line-string.json",
+                              "test/fixtures/multi-line-string.json",
+                              "test/fixtures/polygon.json",
+                              "test/fixtures/multi-polygon.json",
+                              "test/fixtures/geometry-collection.json" }) {
+        rapidjson_document d;
+        readDocument(path, d);
+        const auto owned = convert<geometry>(d);
+        const auto viewed = convert<view::geometry>(d);
+        assert(viewed.which() == owned.which());
+        assert(mapbox::geometry::envelope(viewed) == mapbox::geometry::envelope(owned));
+    }
+
+    rapidjson_document d;
+    readDocument("test/fixtures/polygon.json", d);
+    const auto rings = convert<view::geometry>(d).get<view::polygon>();
+    const auto owned = convert<geometry>(d);
+    const auto &expected = owned.get<polygon>();
+    assert(rings.size() == 1);
+    assert(rings[0].size() == 5);
+    assert(rings[0][0] == rings[0][4]);
+    assert(std::equal(rings[0].begin(), rings[0].end(), expected[0].begin()));
+
+    readDocument("test/fixtures/feature.json", d);
+    const auto f = convert<view::feature>(d);
+    assert(f.geometry.is<point>());
+    assert(f.geometry.get<point>() == (point{ 30.5, 50.5 }));
+    assert(f.properties.size() == 7);
+    assert(f.properties.find("string")->GetString() == std::string("foo"));
+    assert(f.properties.find("missing") == nullptr);
+
+    readDocument("test/fixtures/feature-id.json", d);
+    const auto data = convert<view::geojson>(d);
+    assert(data.is<view::feature_collection>());
+    const auto &features = data.get<view::feature_collection>();
+    assert(features.size() == 2);
+    assert(features[0].id == identifier{ uint64_t(1234) });
+    assert(features[1].id == identifier{ "abcd" });
+
+    try {
+        readDocument("test/fixtures/invalid-polygon.json", d);
+        convert<view::geojson>(d);
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()).find("described by 4") != std::string::npos);
+    }
+
+    try {
+        readDocument("test/fixtures/invalid-multi-polygon-2.json", d);
+        convert<view::geojson>(d);
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()).find("2 numbers") != std::string::npos);
+    }
+}
+
+// Records visitor events as a compact trace.
+class trace_visitor : public visitor {
+public:
+    std::stringstream trace;
+
+    void begin_feature_collection() override {
+        trace << "C(";
+    }
+    void end_feature_collection() override {
+        trace << ")";
+    }
+    void begin_feature() override {
+        trace << "F(";
+    }
+    void end_feature() override {
+        trace << ")";
+    }
+    void feature_id(identifier id) override {
+        trace << "#" << (id.is<std::string>() ? id.get<std::string>() : "n");
+    }
+    void property(std::string key, value) override {
+        trace << "." << key;
+    }
+    void begin_geometry(geometry_type type) override {
+        trace << "G" << int(type) << "(";
+    }
+    void end_geometry(geometry_type) override {
+        trace << ")";
+    }
+    void begin_polygon() override {
+        trace << "P(";
+    }
+    void end_polygon() override {
+        trace << ")";
+    }
+    void begin_line_string() override {
+        trace << "L(";
+    }
+    void end_line_string() override {
+        trace << ")";
+    }
+    void begin_ring() override {
+        trace << "R(";
+    }
+    void end_ring() override {
+        trace << ")";
+    }
+    void position(double x, double y) override {
+        trace << " " << x << "," << y;
+    }
+};
+
+static std::string traceGeoJSON(const std::string &json) {
+    trace_visitor v;
+    parse(json, v);
+    return v.trace.str();
+}
+
+static std::string readFile(const std::string &path) {
+    std::ifstream t(path.c_str());
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    return buffer.str();
+}
+
+// Counts positions so they can be compared against the owning representation.
+class counting_visitor : public visitor {
+public:
+    std::size_t positions = 0;
+    void position(double, double) override {
+        ++positions;
+    }
+};
+
+static void testVisitor() {
+    for (const auto &path : { "test/fixtures/point.json",
+                              "test/fixtures/multi-point.json",
+                              "test/fixtures/line-string.json",
+                              "test/fixtures/multi-line-string.json",
+                              "test/fixtures/polygon.json",
+                              "test/fixtures/multi-polygon.json",
+                              "test/fixtures/geometry-collection.json",
+                              "test/fixtures/feature-collection.json" }) {
+        counting_visitor v;
+        parse(readFile(path), v);
+        std::size_t expected = 0;
+        const auto data = readGeoJSON(path, false);
+        data.match([&](const feature_collection &fc) {
+                       for (const auto &f : fc) {
+                           mapbox::geometry::for_each_point(f.geometry, [&](const point &) { ++expected; });
+                       }
+                   },
+                   [&](const feature &f) {
+                       mapbox::geometry::for_each_point(f.geometry, [&](const point &) { ++expected; });
+                   },
+                   [&](const geometry &g) {
+                       mapbox::geometry::for_each_point(g, [&](const point &) { ++expected; });
+                   });
+        assert(v.positions == expected);
+    }
+
+    assert(traceGeoJSON(readFile("test/fixtures/line-string.json")) ==
+           "G1(L( 30.5,50.5 30.6,50.6))");
+    assert(traceGeoJSON(readFile("test/fixtures/feature-id.json")) ==
+           "C(F(#nG0( 0,0))F(#abcdG0( 0,0)))");
+
+    // Coordinates before the type are buffered; foreign members are skipped.
+    assert(traceGeoJSON(R"({"coordinates": [[[0,0],[1,0],[1,1],[0,0]]], "bbox": [0,0,1,1],
+                            "type": "Polygon"})") == "G2(R( 0,0 1,0 1,1 0,0))");
+    assert(traceGeoJSON(R"({"properties": {"a": [1, {"b": null}], "c": 2}, "geometry": null,
+                            "type": "Feature", "coordinates": {"x": 1}})") == "F(.a.c)");
+    assert(traceGeoJSON(R"({"type": "MultiPolygon", "coordinates": [[[[0,0],[1,0],[1,1],[0,0]]]]})") ==
+           "G5(P(R( 0,0 1,0 1,1 0,0)))");
+    assert(traceGeoJSON(R"({"type": "GeometryCollection", "geometries": [
+                            {"type": "Point", "coordinates": [1,2,3]}]})") == "G6(G0( 1,2))");
+
+    for (const auto &path : { "test/fixtures/invalid-polygon.json",
+                              "test/fixtures/invalid-multi-polygon.json" }) {
+        try {
+            traceGeoJSON(readFile(path));
+            assert(false && "Should have thrown an error");
+        } catch (const std::runtime_error& err) {
+            assert(std::string(err.what()).find("described by 4") != std::string::npos);
+        }
+    }
+
+    try {
+        traceGeoJSON(readFile("test/fixtures/invalid-line-string.json"));
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()).find("two or more") != std::string::npos);
+    }
+
+    try {
+        traceGeoJSON(readFile("test/fixtures/invalid-multi-polygon-2.json"));
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()).find("2 numbers") != std::string::npos);
+    }
+
+    try {
+        traceGeoJSON(readFile("test/fixtures/invalid.json"));
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()).find("Invalid") != std::string::npos);
+    }
+
+    try {
+        traceGeoJSON(R"({"type": "Point"})");
+        assert(false && "Should have thrown an error");
+    } catch (const std::runtime_error& err) {
+        assert(std::string(err.what()) == "Point geometry must have a coordinates property");
+    }
+}
+
+static void testParseOptions() {
+    for (const auto &path : { "test/fixtures/polygon.json",
+                              "test/fixtures/multi-polygon.json",
+                              "test/fixtures/geometry-collection.json",
+                              "test/fixtures/feature.json",
+                              "test/fixtures/feature-collection.json",
+                              "test/fixtures/feature-id.json" }) {
+        const auto json = readFile(path);
+        assert(parse(json, parse_options{}) == parse(json));
+    }
+
+    std::stringstream json;
+    json << R"({"type": "LineString", "coordinates": [)";
+    for (int i = 0; i <= 100; ++i) {
+        json << (i ? "," : "") << "[" << i << "," << (i % 2 ? 0.001 : 0) << "]";
+    }
+    json << "]}";
+
+    parse_options options;
+    options.tolerance = 1;
+    for (const auto algorithm : { parse_options::simplification::douglas_peucker,
+                                  parse_options::simplification::visvalingam }) {
+        options.algorithm = algorithm;
+        const auto simplified = parse(json.str(), options).get<geometry>().get<line_string>();
+        assert(simplified == (line_string{ { 0, 0 }, { 100, 0 } }));
+    }
+
+    options.tolerance = 0;
+    options.grid      = 1;
+    assert(parse(R"({"type": "LineString", "coordinates": [[0.1,0.1],[0.2,0.2],[1.4,1.6]]})", options)
+               .get<geometry>() == (geometry{ line_string{ { 0, 0 }, { 1, 2 } } }));
+    assert(parse(R"({"type": "MultiPoint", "coordinates": [[0.1,0.1],[0.2,0.2]]})", options)
+               .get<geometry>() == (geometry{ multi_point{ { 0, 0 }, { 0, 0 } } }));
+
+    // A ring that collapses takes its holes with it.
+    const auto collapsed = parse(R"({"type": "MultiPolygon", "coordinates": [
+        [[[0,0],[0.2,0],[0.2,0.2],[0,0]], [[0,0],[0.1,0],[0.1,0.1],[0,0]]],
+        [[[0,0],[5,0],[5,5],[0,0]]]]})", options).get<geometry>().get<multi_polygon>();
+    assert(collapsed == (multi_polygon{ { { { 0, 0 }, { 5, 0 }, { 5, 5 }, { 0, 0 } } } }));
+
+    // Geometries with nothing left are null, and left out of GeometryCollections, so the result
+    // stringifies to valid GeoJSON.
+    const auto line = parse(R"({"type": "Feature", "properties": {},
+        "geometry": {"type": "LineString", "coordinates": [[0.1,0.1],[0.2,0.2]]}})", options);
+    assert(line.get<feature>().geometry.is<empty>());
+    assert(parse(stringify(line)) == line);
+
+    const auto members = parse(R"({"type": "GeometryCollection", "geometries": [
+        {"type": "Polygon", "coordinates": [[[0,0],[0.2,0],[0.2,0.2],[0,0]]]},
+        {"type": "MultiLineString", "coordinates": [[[0.1,0.1],[0.2,0.2]]]},
+        {"type": "Point", "coordinates": [0.1,0.1]}]})", options);
+    const geometry_collection remaining{ point{ 0, 0 } };
+    assert(members.get<geometry>() == geometry{ remaining });
+    assert(parse(stringify(members)) == members);
+
+    assert(parse(R"({"type": "Polygon", "coordinates": [[[0,0],[0.2,0],[0.2,0.2],[0,0]]]})", options)
+               .get<geometry>()
+               .is<empty>());
+    assert(parse(R"({"type": "MultiLineString", "coordinates": []})", options)
+               .get<geometry>()
+               .is<multi_line_string>());
+}
+
+static void testTransform() {
+    for (const auto &path : { "test/fixtures/point.json",
+                              "test/fixtures/multi-polygon.json",
+                              "test/fixtures/geometry-collection.json",
+                              "test/fixtures/feature.json",
+                              "test/fixtures/feature-collection.json",
+                              "test/fixtures/feature-id.json" }) {
+        const auto data = parse(readFile(path));
+        assert(stringify(data, stringify_options{}) == stringify(data));
+    }
+
+    point corner{ 180, 85.0511287798065923778 };
+    lonlat_to_mercator(&corner, 1);
+    assert(std::abs(corner.x - 20037508.342789244) < 1e-6);
+    assert(std::abs(corner.y - 20037508.342789244) < 1e-6);
+
+    std::vector<point> points;
+    for (int i = 0; i < 200; ++i) {
+        points.emplace_back(i * 1.7 - 170, i * 0.8 - 80);
+    }
+    auto projected = points;
+    lonlat_to_mercator(projected.data(), projected.size());
+    mercator_to_lonlat(projected.data(), projected.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        assert(std::abs(projected[i].x - points[i].x) < 1e-9);
+        assert(std::abs(projected[i].y - points[i].y) < 1e-9);
+    }
+
+    parse_options options;
+    options.transform = lonlat_to_mercator;
+    const auto mercator = parse(readFile("test/fixtures/polygon.json"), options);
+    const auto expected = parse(readFile("test/fixtures/polygon.json"));
+    auto ring = expected.get<geometry>().get<polygon>().front();
+    lonlat_to_mercator(ring.data(), ring.size());
+    assert(mercator.get<geometry>().get<polygon>().front() == ring);
+
+    stringify_options inverse;
+    inverse.transform = mercator_to_lonlat;
+    const auto roundtrip = parse(stringify(mercator, inverse)).get<geometry>().get<polygon>();
+    const auto &original = expected.get<geometry>().get<polygon>();
+    for (std::size_t i = 0; i < original.front().size(); ++i) {
+        assert(std::abs(roundtrip.front()[i].x - original.front()[i].x) < 1e-9);
+        assert(std::abs(roundtrip.front()[i].y - original.front()[i].y) < 1e-9);
+    }
+}
+
+// Records the coordinates of every position, in order.
+class position_visitor : public visitor {
+public:
+    std::vector<double> coordinates;
+    void position(double x, double y) override {
+        coordinates.push_back(x);
+        coordinates.push_back(y);
+    }
+};
+
+static void testNumberParsing() {
+    const std::vector<std::string> numbers = {
+        "0", "-0", "0.1", "-91.021728515625", "41.393294288784865", "12345678.12345678",
+        "1e22", "1e23", "9007199254740993", "123456789012345678901234", "0.000000000000000000000001234",
+        "1.7976931348623157e308", "5e-324", "2.2250738585072014E-308", "100000000000000000000000.5",
+        "3.14159265358979323846264338327950288", "-1234567890123456789e-25"
+    };
+
+    std::string json = R"({"type": "MultiPoint", "coordinates": [)";
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+        json += (i ? ",[" : "[") + numbers[i] + "," + numbers[i] + "]";
+    }
+    json += "]}";
+
+    position_visitor exact;
+    parse(json, exact);
+    assert(exact.coordinates.size() == numbers.size() * 2);
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+        const double expected = std::strtod(numbers[i].c_str(), nullptr);
+        assert(exact.coordinates[i * 2] == expected);
+        assert(std::signbit(exact.coordinates[i * 2]) == std::signbit(expected));
+    }
+
+    parse_options options;
+    options.full_precision = false;
+    const auto fast = parse(json, options).get<geometry>().get<multi_point>();
+    for (std::size_t i = 0; i < numbers.size(); ++i) {
+        const double expected = std::strtod(numbers[i].c_str(), nullptr);
+        assert(std::abs(fast[i].x - expected) <= std::abs(expected) * 1e-15);
+    }
+
+    const auto f = parse(R"({"type": "Feature", "geometry": null, "id": -9223372036854775808,
+        "properties": {"max": 18446744073709551615, "over": 18446744073709551616, "neg": -5, "real": 1.5}})",
+        parse_options{}).get<feature>();
+    assert(f.id == identifier{ std::int64_t(INT64_MIN) });
+    assert(f.properties.at("max") == value{ std::uint64_t(UINT64_MAX) });
+    assert(f.properties.at("over") == value{ 18446744073709551616.0 });
+    assert(f.properties.at("neg") == value{ std::int64_t(-5) });
+    assert(f.properties.at("real") == value{ 1.5 });
+}
+
+static void testDecimalPlaces() {
+    stringify_options options;
+    options.decimal_places = 6;
+    assert(stringify(geojson{ geometry{ point{ 30.123456789, -0.0000001 } } }, options) ==
+           R"({"type":"Point","coordinates":[30.123457,0]})");
+    assert(stringify(geojson{ geometry{ line_string{ { 1.5, -2 }, { -0.25, 100.0000004 } } } }, options) ==
+           R"({"type":"LineString","coordinates":[[1.5,-2],[-0.25,100]]})");
+
+    options.decimal_places = 0;
+    assert(stringify(geojson{ geometry{ point{ 2.5, -2.5 } } }, options) ==
+           R"({"type":"Point","coordinates":[3,-3]})");
+
+    // Values that cannot be scaled to an integer keep the shortest representation.
+    options.decimal_places = 7;
+    const geojson large{ geometry{ point{ 1e300, 5e-324 } } };
+    assert(parse(stringify(large, options)) == (geojson{ geometry{ point{ 1e300, 0 } } }));
+
+    const auto data = parse(readFile("test/fixtures/feature-collection.json"));
+    options.decimal_places = 17;
+    assert(parse(stringify(data, options)) == data);
+}
+
+static void testTrusted() {
+    parse_options options;
+    options.trusted = true;
+    for (const auto &path : { "test/fixtures/multi-polygon.json",
+                              "test/fixtures/geometry-collection.json",
+                              "test/fixtures/feature-collection.json" }) {
+        const auto json = readFile(path);
+        assert(parse(json, options) == parse(json));
+    }
+
+    const auto line = parse(readFile("test/fixtures/invalid-line-string.json"), options);
+    assert(line.get<feature>().geometry == (geometry{ line_string{ { 30, 40 } } }));
+    const auto ring = parse(R"({"type": "Polygon", "coordinates": [[[0,0],[1,1],[0,0]]]})", options);
+    assert(ring.get<geometry>().get<polygon>().front().size() == 3);
+}
+
+static void expectLimitError(const std::string &json, const parse_limits &limits, const char *message) {
+    parse_options options;
+    options.limits = limits;
+    try {
+        parse(json, options);
+        assert(false && "Should have thrown an error");
+    } catch (const limit_error& err) {
+        assert(std::string(err.what()) == message);
+    }
+}
+
+static void testLimits() {
+    const auto json = readFile("test/fixtures/feature-collection.json");
+
+    parse_limits limits;
+    limits.max_input_bytes          = json.size();
+    limits.max_depth                = 6;
+    limits.max_geometry_coordinates = 4;
+    limits.max_feature_coordinates  = 4;
+    limits.max_document_coordinates = 6;
+    limits.max_properties           = 1;
+    limits.max_string_length        = 17;
+    parse_options options;
+    options.limits = limits;
+    assert(parse(json, options) == parse(json));
+
+    parse_limits exceeded = limits;
+    exceeded.max_input_bytes = json.size() - 1;
+    expectLimitError(json, exceeded,
+                     ("input exceeds the limit of " + std::to_string(json.size() - 1) + " bytes").c_str());
+
+    exceeded = limits;
+    exceeded.max_depth = 5;
+    expectLimitError(json, exceeded, "nesting exceeds the limit of 5 levels");
+
+    exceeded = limits;
+    exceeded.max_geometry_coordinates = 3;
+    expectLimitError(json, exceeded, "geometry exceeds the limit of 3 coordinates");
+
+    exceeded = limits;
+    exceeded.max_document_coordinates = 5;
+    expectLimitError(json, exceeded, "document exceeds the limit of 5 coordinates");
+
+    exceeded = limits;
+    exceeded.max_string_length = 16;
+    expectLimitError(json, exceeded, "string exceeds the limit of 16 characters");
+
+    exceeded = limits;
+    expectLimitError(R"({"type": "Feature", "geometry": null, "properties": {"a": 1, "b": 2}})",
+                     exceeded, "feature exceeds the limit of 1 properties");
+
+    exceeded = parse_limits{};
+    exceeded.max_feature_coordinates = 4;
+    expectLimitError(R"({"type": "Feature", "geometry": {"type": "GeometryCollection", "geometries": [
+                        {"type": "Point", "coordinates": [1, 2]},
+                        {"type": "Point", "coordinates": [3, 4]},
+                        {"type": "Point", "coordinates": [5, 6]}]}})",
+                     exceeded, "feature exceeds the limit of 4 coordinates");
+
+    // Deeply nested property values are rejected before they are built.
+    exceeded = parse_limits{};
+    exceeded.max_depth = 64;
+    std::string deep = R"({"type": "Feature", "geometry": null, "properties": {"a": )";
+    deep += std::string(100000, '[') + std::string(100000, ']') + "}}";
+    expectLimitError(deep, exceeded, "nesting exceeds the limit of 64 levels");
+}
+
+static void testDeepNesting() {
+    // Nested property values convert and stringify without recursing per level.
+    const std::size_t depth = 5000;
+    std::string json = R"({"type":"Feature","geometry":null,"properties":{"a":)";
+    json += std::string(depth, '[') + "1" + std::string(depth, ']') + "}}";
+
+    const geojson parsed = parse(json);
+    const auto &f        = parsed.get<feature>();
+    const value *nested = &f.properties.at("a");
+    for (std::size_t i = 0; i < depth; ++i) {
+        assert(nested->is<value::array_type>());
+        nested = &nested->getArray()->front();
+    }
+    assert(nested->is<uint64_t>());
+    assert(stringify(geojson{ f }) == json);
+    assert(stringify(geojson{ f }, stringify_options{}) == json);
+
+    // So do nested geometry collections.
+    std::string collection;
+    for (std::size_t i = 0; i < depth; ++i) {
+        collection += R"({"type":"GeometryCollection","geometries":[)";
+    }
+    collection += R"({"type":"Point","coordinates":[1.5,2.0]})";
+    for (std::size_t i = 0; i < depth; ++i) {
+        collection += "]}";
+    }
+
+    const geojson parsedCollection = parse(collection);
+    const auto &g                  = parsedCollection.get<geometry>();
+    const geometry *inner = &g;
+    for (std::size_t i = 0; i < depth; ++i) {
+        assert(inner->is<geometry_collection>());
+        inner = &inner->get<geometry_collection>().front();
+    }
+    assert(inner->get<point>() == point(1.5, 2.0));
+    assert(parse(stringify(g)) == geojson{ g });
+    assert(stringify(g, stringify_options{}) == stringify(g));
+
+    // The options writer, which also writes gzip output, doesn't recurse per level either.
+    std::stringstream compressed;
+    stringify_gzip(geojson{ f }, compressed);
+    assert(parse_gzip(compressed) == parsed);
+}
+
+static void testMemoryUsage() {
+    assert(memory_usage(geometry{ point{ 1, 2 } }) == 0);
+
+    line_string line{ { 0, 0 }, { 1, 1 } };
+    assert(memory_usage(geometry{ line }) == 2 * sizeof(point));
+    line_string reserved = line;
+    reserved.reserve(10);
+    assert(memory_usage(geometry{ std::move(reserved) }) == 10 * sizeof(point));
+
+    geometry_collection collection{ line, geometry_collection{ line } };
+    assert(memory_usage(geometry{ collection }) ==
+           2 * sizeof(geometry) + 2 * sizeof(point) + sizeof(geometry) + 2 * sizeof(point));
+
+    feature f{ point{ 1, 2 } };
+    assert(memory_usage(f) == 0);
+    f.id = std::string(100, 'x');
+    assert(memory_usage(f) > 100);
+    f.properties.emplace("tags", value::array_type{ std::string(200, 'y') });
+    assert(memory_usage(f) > 300);
+    assert(memory_usage(f.properties.at("tags")) > 200);
+
+    const auto fc = readGeoJSON("test/fixtures/feature-collection.json", false);
+    assert(memory_usage(fc) > memory_usage(fc.get<feature_collection>().front()));
+
+    // Counting sees each allocation, and the peak includes blocks since freed.
+    {
+        allocation_counter counter;
+        {
+            std::vector<char> scratch(1000);
+        }
+        std::vector<char> kept(500);
+        assert(counter.stats().allocations == 2);
+        assert(counter.stats().bytes == 1500);
+        assert(counter.stats().peak_bytes == 1000);
+    }
+
+    // Nested counters report to the enclosing one.
+    {
+        allocation_counter outer;
+        std::vector<char> kept(100);
+        {
+            allocation_counter inner;
+            std::vector<char> scratch(1000);
+            assert(inner.stats().allocations == 1);
+        }
+        assert(outer.stats().allocations == 2);
+        assert(outer.stats().peak_bytes == 1100);
+    }
+
+    // The parse result's allocations are counted, so peak usage covers it.
+    allocation_stats stats;
+    const auto line_json = R"({"type": "LineString", "coordinates": [[0, 0], [1, 1], [2, 2], [3, 3]]})";
+    const auto parsed = parse(line_json, parse_options{}, stats);
+    assert(parsed.get<geometry>().get<line_string>().size() == 4);
+    assert(stats.allocations > 0);
+    assert(stats.peak_bytes >= memory_usage(parsed));
+    assert(stats.bytes >= stats.peak_bytes);
+}
+
+struct recording_hook : instrumentation_hook {
+    void begin_parse() override {
+        events.push_back("begin_parse");
+    }
+    void end_parse(const instrumentation_stats &stats) override {
+        events.push_back("end_parse");
+        features = stats.features;
+    }
+    void begin_stringify() override {
+        events.push_back("begin_stringify");
+    }
+    void end_stringify(const instrumentation_stats &stats) override {
+        events.push_back("end_stringify");
+        bytes = stats.bytes;
+    }
+
+    std::vector<std::string> events;
+    std::size_t features = 0;
+    std::size_t bytes    = 0;
+};
+
+static void testInstrumentation() {
+    std::ifstream file("test/fixtures/feature-collection.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    instrumentation_stats stats;
+    recording_hook hook;
+    const auto parsed = parse(json, stats, &hook);
+    assert(parsed == parse(json));
+    assert(stats.bytes == json.size());
+    assert(stats.features == 2);
+    assert(stats.vertices == 3);
+    assert(stats.properties == 0);
+    assert(stats.write_time.count() == 0);
+    assert(stats.total_time >= stats.tokenize_time + stats.geometry_time + stats.property_time);
+    assert((hook.events == std::vector<std::string>{ "begin_parse", "end_parse" }));
+    assert(hook.features == 2);
+
+    const std::string output = stringify(parsed, stats, &hook);
+    assert(output == stringify(parsed));
+    assert(stats.bytes == output.size());
+    assert(stats.features == 2);
+    assert(stats.vertices == 3);
+    assert(stats.tokenize_time.count() == 0);
+    assert(stats.total_time >= stats.geometry_time + stats.property_time + stats.write_time);
+    assert(hook.events.size() == 4 && hook.events.back() == "end_stringify");
+    assert(hook.bytes == output.size());
+
+    // Failed parses still report what they read.
+    try {
+        parse("{\"type\": \"Point\", \"coordinates\": [1]}", stats, &hook);
+        assert(false && "should throw");
+    } catch (const std::runtime_error &) {
+        assert(stats.bytes > 0);
+        assert(stats.features == 0);
+        assert(hook.events.back() == "end_parse");
+    }
+}
+
+static void testFrozen() {
+    feature_collection collection;
+    {
+        feature f{ polygon{ { { 0, 0 }, { 4, 0 }, { 4, 4 }, { 0, 0 } },
+                            { { 1, 1 }, { 2, 1 }, { 2, 2 }, { 1, 1 } } } };
+        f.id = std::string("first");
+        f.properties.emplace("name", std::string("a polygon with a hole"));
+        f.properties.emplace("rank", std::uint64_t(3));
+        f.properties.emplace("offset", std::int64_t(-7));
+        f.properties.emplace("area", 15.5);
+        f.properties.emplace("open", true);
+        f.properties.emplace("missing", null_value_t{});
+        f.properties.emplace("tags", value::array_type{ std::string("x"), value::object_type{ { "deep", 1.5 } } });
+        collection.push_back(std::move(f));
+    }
+    {
+        feature f{ geometry_collection{ point{ 1, 2 },
+                                        multi_polygon{ { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 } } } },
+                                        geometry_collection{ line_string{ { 5, 5 }, { 6, 6 } }, geometry{} },
+                                        multi_line_string{ { { 0, 1 }, { 1, 2 } } },
+                                        multi_point{ { 3, 3 }, { 4, 4 } } } };
+        f.id = std::int64_t(-2);
+        collection.push_back(std::move(f));
+    }
+    collection.push_back(feature{ geometry{} });
+
+    const frozen_feature_collection frozen(collection);
+    assert(frozen.size() == 3);
+    assert(frozen.thaw() == collection);
+
+    const auto first = frozen[0];
+    assert(first.id().get_string() == "first");
+    assert(first.geometry().type() == geometry_type::Polygon);
+    assert(first.geometry().size() == 2);
+    assert(first.geometry().part(1).size() == 4);
+    assert(first.geometry().part(1)[2] == point(2, 2));
+
+    const auto properties = first.properties();
+    assert(properties.type() == frozen_value::kind::Object);
+    assert(properties.size() == 7);
+    assert(properties.key(0) == "area");
+    assert(properties.at("area").get_double() == 15.5);
+    assert(properties.at("rank").get_uint() == 3);
+    assert(properties.at("offset").get_int() == -7);
+    assert(properties.at("open").get_bool());
+    assert(properties.at("missing").type() == frozen_value::kind::Null);
+    assert(properties.at("tags")[1].at("deep").get_double() == 1.5);
+    assert(properties.find("absent") == properties.size());
+    try {
+        properties.at("absent");
+        assert(false && "should throw");
+    } catch (const std::out_of_range &) {
+    }
+    assert(properties.at("tags").find("deep") == properties.at("tags").size());
+    try {
+        properties.at("tags").at("deep");
+        assert(false && "should throw");
+    } catch (const std::out_of_range &) {
+    }
+
+    const auto second = frozen[1].geometry();
+    assert(frozen[1].id().get_int() == -2);
+    assert(second.type() == geometry_type::GeometryCollection);
+    assert(second.size() == 5);
+    assert(second[0].points()[0] == point(1, 2));
+    assert(second[1][0].part(0).size() == 4);
+    assert(second[2][1].empty());
+    assert(second[4].points().size() == 2);
+    assert(frozen[2].geometry().empty());
+    assert(frozen[2].id().type() == frozen_value::kind::Null);
+
+    // The frozen block is smaller than the containers it replaces, and views survive a move.
+    assert(frozen.memory_usage() < memory_usage(collection));
+    feature_collection copy = collection;
+    auto moved = freeze(std::move(copy));
+    assert(copy.empty());
+    const auto view = moved[0].properties();
+    const frozen_feature_collection target = std::move(moved);
+    assert(view.at("name").get_string() == "a polygon with a hole");
+    assert(target.thaw() == collection);
+
+    // Shrinking keeps the contents and drops spare capacity.
+    feature_collection grown = collection;
+    grown.reserve(100);
+    grown[0].geometry.get<polygon>()[0].reserve(100);
+    shrink_to_fit(grown);
+    assert(grown == collection);
+    assert(grown.capacity() == grown.size());
+    assert(grown[0].geometry.get<polygon>()[0].capacity() == 4);
+    assert(frozen_feature_collection().empty());
+}
+
+static void testShared() {
+    const auto fc = readGeoJSON("test/fixtures/feature-collection.json", false).get<feature_collection>();
+    std::ifstream file("test/fixtures/feature-collection.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    // Parsed shared collections match plain ones, and serialize the same way.
+    const auto shared = parse<shared_feature_collection>(buffer.str());
+    assert(shared.size() == fc.size());
+    assert(unshare(shared) == fc);
+    assert(stringify(shared) == stringify(fc));
+    assert(stringify(shared[1]) == stringify(fc[1]));
+    assert(parse<shared_feature>(stringify(fc[1])) == shared[1]);
+    rapidjson_allocator allocator;
+    assert(convert(convert(shared, allocator)) == geojson{ fc });
+
+    // Copies share blocks until one of them is modified.
+    shared_feature_collection subset{ shared[1] };
+    assert(subset[0] == shared[1]);
+    assert(subset[0].shares_geometry(shared[1]));
+    assert(subset[0].shares_properties(shared[1]));
+
+    subset[0].mutable_properties().emplace("added", true);
+    assert(!subset[0].shares_properties(shared[1]));
+    assert(subset[0].shares_geometry(shared[1]));
+    assert(shared[1].properties().count("added") == 0);
+    assert(subset[0] != shared[1]);
+
+    subset[0].mutable_geometry() = point{ 7, 8 };
+    assert(!subset[0].shares_geometry(shared[1]));
+    assert(shared[1].geometry() == fc[1].geometry);
+
+    // The only owner modifies in place.
+    shared_feature single{ feature{ point{ 1, 1 } } };
+    const auto *before = &single.geometry();
+    single.mutable_geometry() = point{ 2, 2 };
+    assert(&single.geometry() == before);
+    single.set_id(std::uint64_t(5));
+    assert(single.to_feature() == (feature{ point{ 2, 2 }, {}, std::uint64_t(5) }));
+
+    feature_collection plain = fc;
+    const auto moved = share(std::move(plain));
+    assert(plain.empty());
+    assert(unshare(moved) == fc);
+}
+
+static void testPushParser() {
+    const auto fc = readGeoJSON("test/fixtures/feature-collection.json", false).get<feature_collection>();
+    std::ifstream file("test/fixtures/feature-collection.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    // Chunks of every size give the same features, each as soon as it is complete.
+    for (std::size_t size = 1; size <= json.size(); ++size) {
+        feature_collection received;
+        push_parser parser([&](feature &&f) { received.push_back(std::move(f)); });
+        for (std::size_t i = 0; i < json.size(); i += size) {
+            parser.feed(json.data() + i, std::min(size, json.size() - i));
+        }
+        parser.finish();
+        assert(received == fc);
+    }
+
+    feature_collection received;
+    push_parser parser([&](feature &&f) { received.push_back(std::move(f)); });
+    const auto second = json.find("}, {");
+    parser.feed(json.substr(0, second + 1));
+    assert(received.size() == 1);
+    assert(received[0] == fc[0]);
+    parser.feed(json.substr(second + 1));
+    assert(received.size() == 2);
+    assert(parser.buffered() == 0);
+    parser.finish();
+
+    // Strings containing brackets and quotes don't end a feature early.
+    received.clear();
+    push_parser strings([&](feature &&f) { received.push_back(std::move(f)); });
+    strings.feed(R"({"features":[{"type":"Feature","geometry":null,"properties":{"a":"}]\"{"}}],)");
+    strings.feed(R"("type":"FeatureCollection"})");
+    strings.finish();
+    assert(received.size() == 1);
+    assert(received[0].properties.at("a") == std::string("}]\"{"));
+
+    // Escaped member names and types are compared as parse() decodes them.
+    const std::string escaped = R"({"type":"Feature\u0043ollection","featu\"res":[)" +
+                                stringify(fc[0]) + R"(],"featu\u0072es":[)" + stringify(fc[1]) +
+                                "]}";
+    received.clear();
+    push_parser escapes([&](feature &&f) { received.push_back(std::move(f)); });
+    escapes.feed(escaped);
+    escapes.finish();
+    assert(received.size() == 1);
+    assert(received == parse(escaped).get<feature_collection>());
+
+    // Other documents are parsed by finish().
+    received.clear();
+    push_parser single([&](feature &&f) { received.push_back(std::move(f)); });
+    single.feed(stringify(fc[1]));
+    assert(received.empty());
+    single.finish();
+    assert(received.size() == 1);
+    assert(received[0] == fc[1]);
+
+    const auto fails = [](const std::string &input, std::size_t max_buffer_bytes) {
+        push_parser failing([](feature &&) {}, parse_options{}, max_buffer_bytes);
+        try {
+            for (std::size_t i = 0; i < input.size(); i += 16) {
+                failing.feed(input.substr(i, 16));
+            }
+            failing.finish();
+        } catch (const limit_error &) {
+            return 2;
+        } catch (const std::runtime_error &) {
+            return 1;
+        }
+        return 0;
+    };
+    assert(fails(json, 0) == 0);
+    assert(fails(json, 200) == 0);
+    assert(fails(json, 100) == 2);
+    assert(fails(json.substr(0, json.size() - 3), 0) == 1);
+    assert(fails(json + "{}", 0) == 1);
+    assert(fails(R"({"type":"Point","coordinates":[1,2]})", 0) == 1);
+    assert(fails(R"({"type":"Feature","features":[1]})", 0) == 1);
+    assert(fails(R"({"type":"Feature","features":[]})", 0) == 1);
+
+    // A features member is only streamed once the type is known to be FeatureCollection, so a
+    // Feature may have one as a foreign member.
+    const std::string foreign =
+        R"({"type":"Feature","geometry":null,"properties":{},"features":[)" + stringify(fc[0]) +
+        "]}";
+    received.clear();
+    push_parser member([&](feature &&f) { received.push_back(std::move(f)); });
+    member.feed(foreign);
+    member.finish();
+    assert(received.size() == 1);
+    assert(received[0] == parse(foreign).get<feature>());
+
+    // What surrounds the features is checked as JSON, as parse() checks it.
+    const std::string skeleton =
+        R"({"bbox": [-1.5e2, 0, 10, 2E+1], "features": [], "crs": {"a": [true, false, null]},
+            "name": "a \"b\" \u00e9", "type": "FeatureCollection"})";
+    assert(fails(skeleton, 0) == 0);
+    for (const auto &invalid : { R"({"type":"FeatureCollection","features":[] garbage})",
+                                 R"({"type":"FeatureCollection","features":[],})",
+                                 R"({"type" "FeatureCollection","features":[]})",
+                                 R"({"type":"FeatureCollection","features":[],"n":01})",
+                                 R"({"type":"FeatureCollection","features":[],"n":-})",
+                                 R"({"type":"FeatureCollection","features":[],"n":tru})",
+                                 R"({"type":"FeatureCollection","features":[],"n":[1,]})",
+                                 R"({"type":"FeatureCollection","features":[],"n":{"a":1]})",
+                                 R"({"type":"FeatureCollection","features":[],"n":"\x"})",
+                                 R"({"type":"FeatureCollection","features":[{}] {}})" }) {
+        assert(fails(invalid, 0) == 1);
+    }
+}
+
+static void testGzip() {
+    const auto data = readGeoJSON("test/fixtures/feature-collection.json", false);
+
+    std::stringstream compressed;
+    stringify_gzip(data, compressed);
+    const std::string bytes = compressed.str();
+    assert(bytes.size() > 2 && bytes[0] == '\x1f' && bytes[1] == '\x8b');
+
+    std::stringstream input(bytes);
+    assert(parse_gzip(input) == data);
+
+    // zlib streams are read too.
+    const std::string json = stringify(data);
+    std::string deflated(compressBound(uLong(json.size())), '\0');
+    uLongf deflatedSize = uLongf(deflated.size());
+    compress(reinterpret_cast<Bytef *>(&deflated[0]), &deflatedSize,
+             reinterpret_cast<const Bytef *>(json.data()), uLong(json.size()));
+    deflated.resize(deflatedSize);
+    std::stringstream zlibInput(deflated);
+    assert(parse_gzip(zlibInput) == data);
+
+    // Documents larger than a block are streamed through.
+    feature_collection large;
+    for (int i = 0; i < 20000; ++i) {
+        large.push_back(feature{ point{ double(i), -double(i) }, {}, std::uint64_t(i) });
+    }
+    std::stringstream big;
+    stringify_gzip(geojson{ large }, big, stringify_options{}, 9);
+    assert(big.str().size() < stringify(geojson{ large }).size());
+    std::stringstream bigInput(big.str());
+    assert(parse_gzip(bigInput) == geojson{ large });
+
+    counting_visitor counter;
+    std::stringstream visited(bytes);
+    parse_gzip(visited, counter);
+    assert(counter.positions == 3);
+
+    const auto fails = [](const std::string &input_bytes, const parse_options &options) {
+        std::stringstream failing(input_bytes);
+        try {
+            parse_gzip(failing, options);
+        } catch (const limit_error &) {
+            return 2;
+        } catch (const std::runtime_error &) {
+            return 1;
+        }
+        return 0;
+    };
+    parse_options limited;
+    limited.limits.max_input_bytes = 64;
+    assert(fails(bytes, parse_options{}) == 0);
+    assert(fails(bytes, limited) == 2);
+    assert(fails(bytes.substr(0, bytes.size() / 2), parse_options{}) == 1);
+    assert(fails("not compressed", parse_options{}) == 1);
+    assert(fails(bytes + "trailing", parse_options{}) == 1);
+}
+
+static void testBatch() {
+    std::vector<std::string> inputs;
+    for (const auto &path : { "test/fixtures/point.json",
+                              "test/fixtures/polygon.json",
+                              "test/fixtures/invalid.json",
+                              "test/fixtures/feature.json",
+                              "test/fixtures/feature-collection.json",
+                              "test/fixtures/geometry-collection.json" }) {
+        inputs.push_back(readFile(path));
+    }
+    inputs.push_back("{\"type\":\"Point\",\"coordinates\":[1]}");
+    for (int i = 0; i < 500; ++i) {
+        inputs.push_back(stringify(geojson{ point{ double(i), 1 } }));
+    }
+
+    // Results match serial parsing, in input order, on any number of threads.
+    for (std::size_t threads : { 1, 4 }) {
+        batch_parser parser(threads);
+        assert(parser.threads() == threads);
+        for (int round = 0; round < 2; ++round) {
+            const auto results = parser.parse(inputs);
+            assert(results.size() == inputs.size());
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                try {
+                    const auto expected = parse(inputs[i]);
+                    assert(results[i].ok());
+                    assert(results[i].parsed == expected);
+                } catch (const std::runtime_error &expected) {
+                    assert(!results[i].ok());
+                    try {
+                        std::rethrow_exception(results[i].failure);
+                    } catch (const std::runtime_error &actual) {
+                        assert(std::string(actual.what()) == expected.what());
+                    }
+                }
+            }
+            assert(!results[2].ok());
+            assert(!results[6].ok());
+        }
+        assert(parser.parse(nullptr, 0).empty());
+    }
+
+    // Options apply to every document, and exception types are kept.
+    parse_options options;
+    options.limits.max_input_bytes = 40;
+    batch_parser limited(2, options);
+    const auto results = limited.parse(inputs);
+    assert(results[7].ok());
+    try {
+        std::rethrow_exception(results[1].failure);
+    } catch (const limit_error &) {
+    }
+    assert(batch_parser().threads() > 0);
+}
+
+static void testIngest() {
+    // A collection large enough to be split into many units.
+    feature_collection large;
+    for (int i = 0; i < 300; ++i) {
+        large.push_back(feature{ line_string{ { double(i), 0 }, { 0, double(i) } },
+                                 { { "name", std::string(i % 7, 'x') } },
+                                 std::uint64_t(i) });
+    }
+    {
+        std::ofstream out("build/ingest-large.json");
+        out << stringify(geojson{ large });
+    }
+    {
+        std::ofstream out("build/ingest-truncated.json");
+        const auto json = stringify(geojson{ large });
+        out << json.substr(0, json.size() - 10);
+    }
+
+    const std::vector<std::string> paths{ "build/ingest-large.json",
+                                          "test/fixtures/feature.json",
+                                          "test/fixtures/point.json",
+                                          "test/fixtures/feature-collection.json",
+                                          "build/ingest-missing.json",
+                                          "build/ingest-truncated.json" };
+
+    for (std::size_t threads : { 1, 3 }) {
+        std::mutex mutex;
+        std::vector<std::map<std::size_t, feature>> received(paths.size());
+        ingest_options options;
+        options.threads    = threads;
+        options.unit_bytes = 512;
+        const auto failures = ingest(paths,
+                                     [&](std::size_t file, std::size_t index, feature &&f) {
+                                         std::lock_guard<std::mutex> lock(mutex);
+                                         assert(received[file].emplace(index, std::move(f)).second);
+                                     },
+                                     options);
+        assert(failures.size() == paths.size());
+
+        assert(!failures[0]);
+        assert(received[0].size() == large.size());
+        for (std::size_t i = 0; i < large.size(); ++i) {
+            assert(received[0].at(i) == large[i]);
+        }
+
+        assert(!failures[1]);
+        assert(received[1].size() == 1);
+        assert(received[1].at(0) == readGeoJSON("test/fixtures/feature.json", false).get<feature>());
+
+        assert(failures[2]);
+        assert(received[2].empty());
+
+        assert(!failures[3]);
+        const auto fc = readGeoJSON("test/fixtures/feature-collection.json", false).get<feature_collection>();
+        assert(received[3].size() == fc.size());
+        assert(received[3].at(1) == fc[1]);
+
+        assert(failures[4]);
+        assert(failures[5]);
+        assert(received[5].empty());
+    }
+
+    // The input size is limited for the whole file, and other limits for each feature of a file
+    // that is split.
+    const auto limited = [&](const parse_limits &limits, std::size_t unit_bytes) {
+        std::atomic<std::size_t> count{ 0 };
+        ingest_options options;
+        options.parsing.limits = limits;
+        options.unit_bytes     = unit_bytes;
+        const auto failures    = ingest({ "build/ingest-large.json" },
+                                     [&](std::size_t, std::size_t, feature &&) { ++count; },
+                                     options);
+        if (!failures[0])
+            return count == large.size();
+        try {
+            std::rethrow_exception(failures[0]);
+        } catch (const limit_error &) {
+        }
+        return false;
+    };
+    parse_limits bytes;
+    bytes.max_input_bytes = 1000;
+    assert(!limited(bytes, 256));
+    assert(!limited(bytes, 1 << 20));
+    parse_limits coordinates;
+    coordinates.max_document_coordinates = 4;
+    assert(limited(coordinates, 256));
+    assert(!limited(coordinates, 1 << 20));
+
+    // An exception from the callback stops its file.
+    const auto failures = ingest({ "test/fixtures/feature.json" },
+                                 [](std::size_t, std::size_t, feature &&) { throw std::runtime_error("stop"); });
+    try {
+        std::rethrow_exception(failures[0]);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "stop");
+    }
+
+    std::remove("build/ingest-large.json");
+    std::remove("build/ingest-truncated.json");
+}
+
+static void testHilbert() {
+    // Points on a grid in row order, and a feature without positions first.
+    feature_collection grid{ feature{ mapbox::geometry::empty{} } };
+    const int size = 100;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            grid.push_back(feature{ point{ double(x), double(y) }, {}, std::uint64_t(y * size + x) });
+        }
+    }
+
+    for (std::size_t threads : { 1, 4 }) {
+        const auto order = hilbert_order(grid, threads);
+        assert(order.size() == grid.size());
+        assert(order.back() == 0);
+        std::vector<std::size_t> sorted = order;
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            assert(sorted[i] == i);
+        }
+
+        // Consecutive features along the curve are close together.
+        double length = 0;
+        for (std::size_t i = 1; i + 1 < order.size(); ++i) {
+            const auto &a = grid[order[i - 1]].geometry.get<point>();
+            const auto &b = grid[order[i]].geometry.get<point>();
+            length += std::abs(a.x - b.x) + std::abs(a.y - b.y);
+        }
+        assert(length < 1.2 * size * size);
+
+        feature_collection copy = grid;
+        hilbert_sort(copy, threads);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            assert(copy[i] == grid[order[i]]);
+        }
+    }
+    assert(hilbert_order(feature_collection{}).empty());
+
+    // The stringify option writes the same order without changing the collection.
+    stringify_options options;
+    options.spatial_order = true;
+    feature_collection sorted = grid;
+    hilbert_sort(sorted);
+    assert(stringify(geojson{ grid }, options) == stringify(geojson{ sorted }, stringify_options{}));
+    assert(stringify(geojson{ grid }, options) != stringify(geojson{ grid }, stringify_options{}));
+}
+
+static void testTiles() {
+    feature_collection fc{
+        feature{ point{ 0.5, 0.5 } },
+        feature{ polygon{ { { -10, -10 }, { 10, -10 }, { 10, 10 }, { -10, 10 }, { -10, -10 } } } },
+        feature{ mapbox::geometry::empty{} },
+        feature{ line_string{ { -179, 80 }, { -170, 89 } } },
+    };
+    tile_index_options options;
+    options.max_zoom = 3;
+    const tile_index index(fc, options);
+
+    const auto listed = [&](std::uint32_t z, std::uint32_t x, std::uint32_t y) {
+        const auto tile = index.features(z, x, y);
+        return std::vector<std::uint32_t>(tile.begin(), tile.end());
+    };
+    assert(listed(0, 0, 0) == (std::vector<std::uint32_t>{ 0, 1, 3 }));
+    assert(listed(1, 1, 0) == (std::vector<std::uint32_t>{ 0, 1 }));
+    assert(listed(1, 0, 0) == (std::vector<std::uint32_t>{ 1, 3 }));
+    assert(listed(1, 0, 1) == (std::vector<std::uint32_t>{ 1 }));
+    assert(listed(3, 0, 0) == (std::vector<std::uint32_t>{ 3 }));
+    assert(listed(3, 7, 7).empty());
+    assert(index.features(4, 0, 0).empty());
+    assert(index.features(1, 2, 0).empty());
+    // The point and line touch one tile at each zoom level, and the polygon four below zoom 0.
+    assert(index.entries() == 3 + 3 * (1 + 4 + 1));
+    assert(index.memory_usage() > 0);
+
+    // Many features give the same lists on any number of threads, and from boxes.
+    feature_collection many;
+    std::vector<bounding_box> boxes;
+    for (int i = 0; i < 5000; ++i) {
+        const double x = (i * 37 % 360) - 180.0;
+        const double y = (i * 11 % 170) - 85.0;
+        many.push_back(feature{ line_string{ { x, y }, { x + (i % 5), y + (i % 3) } } });
+        boxes.push_back(compute_bounding_box(many.back().geometry));
+    }
+    options.max_zoom = 6;
+    options.threads  = 1;
+    const tile_index serial(many, options);
+    options.threads = 4;
+    const tile_index parallel(many, options);
+    const tile_index fromBoxes(boxes, options);
+    assert(serial.entries() == parallel.entries());
+    assert(serial.tiles() == parallel.tiles());
+    std::size_t total = 0;
+    for (std::uint32_t z = 0; z <= 6; ++z) {
+        for (std::uint32_t x = 0; x < (1u << z); ++x) {
+            for (std::uint32_t y = 0; y < (1u << z); ++y) {
+                const auto a = serial.features(z, x, y);
+                const auto b = parallel.features(z, x, y);
+                const auto c = fromBoxes.features(z, x, y);
+                assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+                assert(std::equal(a.begin(), a.end(), c.begin(), c.end()));
+                assert(std::is_sorted(a.begin(), a.end()));
+                total += a.size();
+            }
+        }
+    }
+    assert(total == serial.entries());
+
+    options.max_entries = 100;
+    try {
+        tile_index limited(many, options);
+        assert(false);
+    } catch (const limit_error &) {
+    }
+
+    // By default a box spanning the world is refused before its entries are allocated.
+    const std::vector<bounding_box> world{ bounding_box{ { -180, -85 }, { 180, 85 } } };
+    try {
+        tile_index huge(world);
+        assert(false);
+    } catch (const limit_error &) {
+    }
+    options.max_zoom = 25;
+    try {
+        tile_index invalid(fc, options);
+        assert(false);
+    } catch (const limit_error &) {
+        assert(false);
+    } catch (const std::runtime_error &) {
+    }
+}
+
+static void testTopology() {
+    // Two squares sharing an edge, a line running along part of the first square's boundary
+    // in reverse, and a collection holding a point and a missing geometry.
+    const polygon left{ { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { 0, 0 } } };
+    const polygon right{ { { 1, 0 }, { 2, 0 }, { 2, 1 }, { 1, 1 }, { 1, 0 } } };
+    feature first{ left };
+    first.id                 = std::string{ "left" };
+    first.properties["name"] = std::string{ "first" };
+    feature_collection fc{
+        first,
+        feature{ multi_polygon{ right } },
+        feature{ line_string{ { 0, 0 }, { 0, 1 } } },
+        feature{ geometry_collection{ point{ 5, 5 }, mapbox::geometry::empty{},
+                                      geometry_collection{ line_string{ { 1, 1 }, { 1, 0 } } } } },
+        feature{ mapbox::geometry::empty{} },
+    };
+
+    const topology topo = to_topology(fc);
+    assert(topo.features.size() == fc.size());
+    assert(topo.to_feature_collection() == fc);
+
+    // The first square is cut at its corners, where the other square and the line meet it,
+    // and the second square adds the rest of its boundary. The lines reuse arcs of the squares.
+    assert(topo.arcs.size() == 5);
+    const auto &shared = topo.features[0].geometry.paths[0];
+    const auto &other  = topo.features[1].geometry.paths[0];
+    std::size_t reused = 0;
+    for (const arc_index a : shared) {
+        for (const arc_index b : other) {
+            if (a == ~b)
+                ++reused;
+        }
+    }
+    assert(reused == 1);
+    assert(topo.features[2].geometry.paths[0].size() == 1);
+    assert(topo.features[2].geometry.paths[0][0] < 0);
+    assert(topo.features[4].geometry.null);
+
+    // A hole and the island filling it share one arc, though the island starts at another
+    // corner and runs the other way. Rings without junctions start at their lowest position.
+    const polygon lake{ { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 }, { 0, 0 } },
+                        { { 2, 2 }, { 2, 8 }, { 8, 8 }, { 8, 2 }, { 2, 2 } } };
+    const polygon island{ { { 8, 2 }, { 8, 8 }, { 2, 8 }, { 2, 2 }, { 8, 2 } } };
+    const topology water = to_topology(feature_collection{ feature{ lake }, feature{ island } });
+    assert(water.arcs.size() == 2);
+    assert(water.features[1].geometry.paths[0].size() == 1);
+    assert(water.features[1].geometry.paths[0][0] == ~water.features[0].geometry.paths[1][0]);
+    assert(water.to_feature(0).geometry == geometry{ lake });
+    const polygon rotated{ { { 2, 2 }, { 8, 2 }, { 8, 8 }, { 2, 8 }, { 2, 2 } } };
+    assert(water.to_feature(1).geometry == geometry{ rotated });
+
+    // TopoJSON round trip.
+    const std::string json = stringify_topology(topo);
+    const topology parsed  = parse_topology(json);
+    assert(parsed.arcs.size() == topo.arcs.size());
+    assert(parsed.to_feature_collection() == fc);
+    assert(stringify_topology(parsed) == json);
+
+    // A quantized topology with delta encoded arcs.
+    const topology quantized = parse_topology(R"({"type":"Topology",
+        "transform":{"scale":[0.5,0.25],"translate":[100,10]},
+        "objects":{
+            "lines":{"type":"LineString","id":7,"arcs":[-2,-1]},
+            "places":{"type":"GeometryCollection","geometries":[
+                {"type":"Point","coordinates":[2,4],"properties":{"kind":"town"}},
+                {"type":"Polygon","arcs":[[0,1,2]]}]}},
+        "arcs":[[[0,0],[2,0]],[[2,0],[0,4]],[[2,4],[-2,-4]]]})");
+    const auto collection = quantized.to_feature_collection();
+    assert(collection.size() == 3);
+    assert(collection[0].id == identifier{ std::uint64_t(7) });
+    const geometry line = line_string{ { 101, 11 }, { 101, 10 }, { 100, 10 } };
+    const geometry town = point{ 101, 11 };
+    const geometry area = polygon{ { { 100, 10 }, { 101, 10 }, { 101, 11 }, { 100, 10 } } };
+    assert(collection[0].geometry == line);
+    assert(collection[1].geometry == town);
+    assert(collection[1].properties.at("kind") == value{ std::string{ "town" } });
+    assert(collection[2].geometry == area);
+
+    bool threw = false;
+    try {
+        parse_topology(R"({"type":"Topology","objects":{"a":{"type":"LineString","arcs":[3]}},"arcs":[]})");
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+static void testColumns() {
+    feature_collection fc(4, feature{ point{ 0, 0 } });
+    fc[0].properties = { { "name", std::string{ "a" } }, { "count", std::uint64_t(3) },
+                         { "area", 1.5 }, { "open", true }, { "tags", value::array_type{ value{ 1.0 } } } };
+    fc[1].properties = { { "name", std::string{ "b" } }, { "count", std::int64_t(-2) },
+                         { "area", std::uint64_t(2) }, { "open", null_value_t{} } };
+    fc[2].properties = { { "count", std::uint64_t(7) }, { "tags", std::string{ "x" } } };
+    fc[3].properties = { { "area", std::int64_t(-4) }, { "big", std::uint64_t(1) << 63 } };
+
+    const property_table table(fc);
+    assert(table.size() == 4);
+    assert(table.columns().size() == 6);
+    assert(table.columns()[0].name() == "area");
+    assert(table.find("missing") == nullptr);
+
+    const auto *area = table.find("area");
+    assert(area->type() == column_type::Double);
+    assert(area->doubles()[0] == 1.5);
+    assert(area->doubles()[1] == 2);
+    assert(!area->contains(2));
+    assert(area->doubles()[3] == -4);
+    assert(table.get(3, "area") == value{ std::int64_t(-4) });
+    assert(table.get(0, "area") == value{ 1.5 });
+
+    const auto *count = table.find("count");
+    assert(count->type() == column_type::Int);
+    assert(count->ints()[1] == -2);
+    assert(count->ints()[2] == 7);
+    assert(!count->contains(3));
+
+    assert(table.find("name")->type() == column_type::String);
+    assert(table.find("name")->strings()[1] == "b");
+    assert(table.find("open")->type() == column_type::Bool);
+    assert(table.find("open")->cells()[1] == property_column::cell::Null);
+    assert(table.get(1, "open") == value{});
+    assert(table.find("tags")->type() == column_type::Mixed);
+    assert(table.find("big")->type() == column_type::Uint);
+    assert(table.get(3, "big") == value{ std::uint64_t(1) << 63 });
+
+    // Properties come back with the types they had, whatever the column types.
+    for (std::size_t i = 0; i < fc.size(); ++i) {
+        assert(table.properties(i) == fc[i].properties);
+    }
+    assert(table.get(2, "count") == value{ std::uint64_t(7) });
+    assert(table.properties(1).at("open") == value{});
+    assert(table.memory_usage() > 0);
+
+    feature_collection taken = fc;
+    const property_table moved = take_properties(taken);
+    assert(taken[0].properties.empty());
+    for (std::size_t i = 0; i < fc.size(); ++i) {
+        assert(moved.properties(i) == table.properties(i));
+    }
+}
+
+static void testFilter() {
+    const auto road = [](const char *highway, std::uint64_t lanes) {
+        feature result{ line_string{ { 0, 0 }, { 1, 1 } } };
+        result.properties = { { "highway", std::string{ highway } }, { "lanes", lanes } };
+        return result;
+    };
+
+    const feature_filter roads("highway in (primary, secondary) and lanes >= 2");
+    assert(roads(road("primary", 2)));
+    assert(roads(road("secondary", 4)));
+    assert(!roads(road("primary", 1)));
+    assert(!roads(road("residential", 3)));
+    assert(!roads.uses_geometry_type());
+
+    const feature_filter typed("$type == 'LineString' && !(lanes < 3 || highway == \"primary\")");
+    assert(typed.uses_geometry_type());
+    assert(typed(road("secondary", 3)));
+    assert(!typed(road("primary", 3)));
+    assert(!typed(feature{ point{ 0, 0 }, road("secondary", 3).properties }));
+    assert(feature_filter("$type == null")(feature{}));
+    assert(feature_filter("missing == null and lanes != 'two' and lanes == 2.0")(road("x", 2)));
+    assert(feature_filter("highway not in (primary) and lanes > -1")(road("x", 0)));
+    assert(feature_filter("lanes == 2e0 and lanes < 1.5E+1 and lanes > -0.5e-3")(road("x", 2)));
+
+    for (const char *invalid : { "", "lanes >", "lanes >= 2 and", "(lanes == 2", "lanes == 2)",
+                                 "lanes in 2", "$size == 1", "'open", "lanes == 0x10",
+                                 "lanes > -inf", "lanes == 1.", "lanes == 1e", "lanes == .5",
+                                 "lanes in (1st)" }) {
+        bool threw = false;
+        try {
+            feature_filter{ invalid };
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Properties before and after the geometry, and a rejected feature in between. Geometries
+    // of rejected features are not built, so the transform never sees them.
+    const std::string json = R"({"type":"FeatureCollection","features":[
+        {"type":"Feature","properties":{"highway":"primary","lanes":2},
+         "geometry":{"type":"LineString","coordinates":[[0,0],[1,1]]}},
+        {"type":"Feature","properties":{"highway":"primary","lanes":1},
+         "geometry":{"type":"Polygon","coordinates":[[[0,0],[1,0],[1,1],[0,0]]]}},
+        {"type":"Feature","geometry":{"type":"MultiLineString","coordinates":[[[2,2],[3,3]]]},
+         "properties":{"highway":"secondary","lanes":3}},
+        {"type":"Feature","geometry":{"type":"Point","coordinates":[5,5]},
+         "properties":{"highway":"residential","lanes":3}},
+        {"type":"Feature","geometry":null,"properties":{"highway":"primary","lanes":2}}]})";
+
+    std::size_t runs = 0;
+    parse_options options;
+    options.transform = [&](point *, std::size_t) { ++runs; };
+    options.filter    = std::make_shared<feature_filter>(roads);
+    const auto kept   = parse(json, options).get<feature_collection>();
+
+    const auto all = parse(json).get<feature_collection>();
+    feature_collection expected;
+    std::copy_if(all.begin(), all.end(), std::back_inserter(expected), roads);
+    assert(kept.size() == 3);
+    assert(kept == expected);
+    assert(runs == 2);
+
+    options.filter = std::make_shared<feature_filter>("$type in (Polygon, Point)");
+    runs           = 0;
+    const auto shapes = parse(json, options).get<feature_collection>();
+    assert(shapes.size() == 2);
+    assert(shapes[0] == all[1]);
+    assert(shapes[1] == all[3]);
+    assert(runs == 2);
+
+    // A lone Feature is kept by parse() whatever the filter says, and skipped by the push parser.
+    const std::string loneJSON =
+        R"({"type":"Feature","properties":{"highway":"primary"},"geometry":null})";
+    assert(parse(loneJSON, options) == parse(loneJSON));
+
+    feature_collection received;
+    push_parser parser([&](feature &&f) { received.push_back(std::move(f)); }, options);
+    parser.feed(json);
+    parser.finish();
+    assert(received == shapes);
+
+    received.clear();
+    push_parser lone([&](feature &&f) { received.push_back(std::move(f)); }, options);
+    lone.feed(loneJSON);
+    lone.finish();
+    assert(received.empty());
+
+    // An empty FeatureCollection in place of a feature is an error, not a rejected feature.
+    push_parser nested([](feature &&) {}, options);
+    bool threw = false;
+    try {
+        nested.feed(R"({"type":"FeatureCollection","features":)"
+                    R"([{"type":"FeatureCollection","features":[]}]})");
+        nested.finish();
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+static void testIdIndex() {
+    feature_collection fc(6, feature{ point{ 0, 0 } });
+    fc[0].id = std::uint64_t(1);
+    fc[1].id = std::int64_t(-1);
+    fc[2].id = 1.0;
+    fc[3].id = std::string{ "1" };
+    fc[4].id = std::uint64_t(1);
+    // fc[5] has no id.
+
+    const id_index index(fc);
+    assert(index.size() == 4);
+    assert(index.find(identifier{ std::uint64_t(1) }) == 0);
+    assert(index.find(identifier{ std::int64_t(-1) }) == 1);
+    assert(index.find(identifier{ 1.0 }) == 2);
+    assert(index.find(identifier{ -0.0 }) == id_index::npos);
+    assert(index.find(identifier{ std::string{ "1" } }) == 3);
+    assert(index.find(identifier{ std::string{ "2" } }) == id_index::npos);
+    assert(index.find(identifier{}) == id_index::npos);
+    assert(index.memory_usage() > 0);
+
+    // Many ids give the same index on any number of threads, and survive edits.
+    feature_collection many(20000, feature{ point{ 0, 0 } });
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        if (i % 2) {
+            many[i].id = std::string{ "feature-" } + std::to_string(i);
+        } else {
+            many[i].id = std::uint64_t(i * 7919);
+        }
+    }
+    const id_index serial(many, 1);
+    id_index parallel(many, 4);
+    assert(serial.size() == many.size());
+    assert(parallel.size() == many.size());
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        assert(serial.find(many[i].id) == i);
+        assert(parallel.find(many[i].id) == i);
+    }
+
+    for (std::size_t i = 0; i < many.size(); i += 3) {
+        assert(parallel.erase(many[i].id));
+    }
+    assert(!parallel.erase(many[0].id));
+    parallel.insert(identifier{ std::string{ "added" } }, 5);
+    parallel.insert(many[1].id, 2);
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        const std::size_t expected = i % 3 == 0 ? id_index::npos : i == 1 ? 2 : i;
+        assert(parallel.find(many[i].id) == expected);
+    }
+    assert(parallel.find(identifier{ std::string{ "added" } }) == 5);
+    assert(parallel.size() == many.size() - (many.size() + 2) / 3 + 1);
+
+    id_index grown;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        grown.insert(identifier{ std::int64_t(-std::int64_t(i)) }, i);
+    }
+    assert(grown.size() == 1000);
+    assert(grown.find(identifier{ std::int64_t(-999) }) == 999);
+}
+
 void testAll(bool use_convert) {
     testPoint(use_convert);
     testMultiPoint(use_convert);
@@ -313,6 +1886,29 @@ int main() {
     testEmpty();
     testAll(true);
     testAll(false);
+    testView();
+    testVisitor();
+    testParseOptions();
+    testTransform();
+    testNumberParsing();
+    testDecimalPlaces();
+    testTrusted();
+    testLimits();
+    testDeepNesting();
+    testMemoryUsage();
+    testInstrumentation();
+    testFrozen();
+    testShared();
+    testPushParser();
+    testGzip();
+    testBatch();
+    testIngest();
+    testHilbert();
+    testTiles();
+    testTopology();
+    testColumns();
+    testFilter();
+    testIdIndex();
     return 0;
 }
 
@@ -82,6 +82,19 @@ void test(const std::string &path, bool use_convert = false) {
     assert(result.is<Expected>());
 }
 
+// Nested geometry collections round trip through values without recursing per level.
+void testDeepGeometryCollection() {
+    const std::size_t depth = 5000;
+    geometry nested{ point{ 1, 2 } };
+    for (std::size_t i = 0; i < depth; ++i) {
+        nested = geometry{ geometry_collection{ std::move(nested) } };
+    }
+
+    const mapbox::geojson::value converted = convert(geojson{ nested });
+    const geojson roundTrip                = convert(converted);
+    assert(roundTrip == geojson{ nested });
+}
+
 int main() {
     test("test/fixtures/null.json", true);
     test("test/fixtures/point.json");
@@ -101,5 +114,6 @@ int main() {
     } catch (const std::runtime_error &err) {
         assert(std::string(err.what()).find("Invalid") != std::string::npos);
     }
+    testDeepGeometryCollection();
     return 0;
 }